@@ -20,12 +20,128 @@
 
 #include "ASTFileTree.h"
 
+#include "Readers/FileReader.h"
+
 namespace Ast
 {
 
     ASTFileTree::ASTFileTree(const ContentStream::Ptr& reader)
-        : _fileLexer{ FileLexer::Create(reader) },
+        : _sideTables{ LexerSideTables::Create(reader) },
+          _fileLexer{ FileLexer::Create(reader, _sideTables) },
           _fileReader{ reader }
     {
+        RebuildNodeTable();
+    }
+
+    void ASTFileTree::RebuildNodeTable()
+    {
+        // the version is taken before the build, so a change made meanwhile makes the next query build it again
+        const auto version = _sideTables ? _sideTables->GetTreeVersion() : NodeTableState::notBuilt;
+        auto table = std::make_shared<NodeTable>();
+        table->Build(_fileLexer);
+
+        const std::lock_guard lock{ _nodeTableState.mutex };
+        _nodeTableState.table = std::move(table);
+        _nodeTableState.builtVersion = version;
+    }
+
+    std::shared_ptr<NodeTable> ASTFileTree::AcquireNodeTable() const
+    {
+        const std::lock_guard lock{ _nodeTableState.mutex };
+        if (_sideTables && _nodeTableState.builtVersion != _sideTables->GetTreeVersion())
+        {
+            // a new table is built instead of rebuilding the current one, the running walks keep iterating it
+            const auto version = _sideTables->GetTreeVersion();
+            auto table = std::make_shared<NodeTable>();
+            table->Build(_fileLexer);
+            _nodeTableState.table = std::move(table);
+            _nodeTableState.builtVersion = version;
+        }
+        return _nodeTableState.table;
+    }
+
+    void ASTFileTree::LogStop(LogCollector& logCollector) const
+    {
+        const auto stopReason = _sideTables->GetStopReason();
+        if (stopReason == LexerSideTables::StopReason::TimeBudget)
+        {
+            const auto budget = static_cast<long long>(_sideTables->GetParseOptions().timeBudget.count());
+            logCollector.AddLog({ String::Format("FileParser: the time budget of {} ms was exceeded, the tree is partial", budget),
+                                  LogCollector::LogType::Error });
+        }
+        else if (stopReason == LexerSideTables::StopReason::Cancelled)
+        {
+            logCollector.AddLog({ "FileParser: the parsing was cancelled, the tree is partial", LogCollector::LogType::Error });
+        }
+    }
+
+    String ASTFileTree::GetFileName() const
+    {
+        if (const auto fileReader = boost::dynamic_pointer_cast<const FileReader>(_fileReader))
+        {
+            return String(fileReader->GetPathToFile().string().c_str());
+        }
+        return {};
+    }
+
+    void ASTFileTree::Teardown()
+    {
+        // iterative, so deeply nested trees don't recurse in destructors
+        std::vector<BaseLexer::Ptr> lexers;
+        if (_fileLexer)
+        {
+            lexers.push_back(std::move(_fileLexer));
+        }
+
+        while (!lexers.empty())
+        {
+            auto lexer = std::move(lexers.back());
+            lexers.pop_back();
+
+            for (auto&& child : lexer->DetachChildLexers())
+            {
+                lexers.push_back(std::move(child));
+            }
+        }
+
+        {
+            const std::lock_guard lock{ _nodeTableState.mutex };
+            _nodeTableState.table = std::make_shared<NodeTable>();
+            _nodeTableState.builtVersion = NodeTableState::notBuilt;
+        }
+        _fileLexer.reset();
+        _sideTables.reset();
+        _fileReader.reset();
+    }
+
+    MemoryUsageInfo ASTFileTree::MemoryUsage(const LogCollector* logCollector /* = nullptr*/) const
+    {
+        MemoryUsageInfo usage;
+
+        if (_fileReader)
+        {
+            usage.contentStream = _fileReader->GetMemoryUsage();
+        }
+
+        ForEach(
+            [&usage](const BaseLexer* lexer, Params)
+            {
+                lexer->CollectMemoryUsage(usage);
+                return true;
+            });
+
+        if (_sideTables)
+        {
+            usage.details += _sideTables->GetMemoryUsage();
+        }
+
+        usage.nodeTable = AcquireNodeTable()->GetMemoryUsage();
+
+        if (logCollector)
+        {
+            usage.logs = logCollector->GetMemoryUsage();
+        }
+
+        return usage;
     }
 } // namespace Ast
\ No newline at end of file
@@ -22,9 +22,17 @@
 
 #include "FileParser.h"
 #include "Lexers/FileLexer.h"
+#include "MemoryUsage.h"
+#include "NodeTable.h"
+#include "ParseOptions.h"
 #include "Readers/ContentStream.h"
 #include "Utils/CopyableAndMoveableBehaviour.h"
 
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+
 namespace Ast
 {
 
@@ -48,56 +56,107 @@ namespace Ast
         explicit ASTFileTree(const ContentStream::Ptr& reader);
         ~ASTFileTree() override = default;
 
+        /**
+         * @brief Releases all the lexers of the tree and the content stream right now
+         * @details The tree owns its lexers, so they are freed with the last copy of the tree anyway. Teardown is for
+         * the cases when lexers are still referenced outside: every lexer is detached from its parent and children, so
+         * only the lexers held by the caller survive, each of them as a standalone one.
+         */
+        void Teardown();
+
         template<IsFileParser Parser>
-        void ParseUsing(LogCollector& logCollector)
+        void ParseUsing(LogCollector& logCollector, const ParseOptions& options = {})
         {
+            const LogCollector::FileScope fileScope{ Symbol(GetFileName()) };
+
             if (!Verify(!!_fileReader, "File reader was nullptr"))
             {
                 logCollector.AddLog({ "File reader was nullptr", LogCollector::LogType::Error });
                 return;
             }
 
+            _sideTables->SetParseOptions(options);
+
             Parser parser;
-            parser.Parse(_fileReader, logCollector);
+            parser.Parse(_sideTables, logCollector);
 
-            parser.IterateOverLexers(
-                [&](BaseLexer* lexer)
+            const auto bindToFile = [&](BaseLexer* lexer)
+            {
+                if (!Verify(lexer, "Some lexer was nullptr but expected a valid object."))
                 {
-                    if (!Verify(lexer, "Some lexer was nullptr but expected a valid object."))
-                    {
-                        logCollector.AddLog({ "Some lexer was nullptr but expected a valid object.", LogCollector::LogType::Error });
-                        return true;
-                    }
+                    logCollector.AddLog({ "Some lexer was nullptr but expected a valid object.", LogCollector::LogType::Error });
+                    return true;
+                }
 
-                    if (!lexer->HasParent())
-                    {
-                        _fileLexer->ForceSetAsChild(lexer);
-                    }
+                if (!lexer->HasParent())
+                {
+                    _fileLexer->ForceSetAsChild(lexer);
+                }
 
-                    return true;
-                });
+                return true;
+            };
+            if constexpr (requires { parser.ForEachLexer(bindToFile); })
+            {
+                parser.ForEachLexer(bindToFile);
+            }
+            else
+            {
+                parser.IterateOverLexers(bindToFile);
+            }
 
             _fileLexer->DoValidate(logCollector);
+
+            RebuildNodeTable();
+            LogStop(logCollector);
+        }
+
+        /// @brief false if the parsing was stopped by the time budget or the cancellation token, the tree is partial then.
+        /// A torn down tree has no parsing which could be stopped, so it's complete
+        [[nodiscard]] bool IsComplete() const noexcept
+        {
+            return !_sideTables || _sideTables->GetStopReason() == LexerSideTables::StopReason::None;
         }
 
         [[nodiscard]] ContentStream::Ptr GetReader() const { return _fileReader; }
 
+        /// @brief path of the parsed file, empty if the content isn't read from a file
+        [[nodiscard]] String GetFileName() const;
+
+        /// @brief cold data of all the lexers of the tree
+        [[nodiscard]] LexerSideTables::CPtr GetSideTables() const { return _sideTables; }
+
+        /**
+         * @brief Calculates bytes held by the tree: the content buffer and all the lexers with their data
+         * @param logCollector if passed, its log entries are accounted too
+         */
+        [[nodiscard]] MemoryUsageInfo MemoryUsage(const LogCollector* logCollector = nullptr) const;
+
+        /**
+         * @brief Flat view over the lexers which the queries below walk
+         * @details Every change of the lexers tree (attaching or detaching a lexer, renaming it by a modifier) bumps the
+         * version of the side tables, and a new view is built on the next query if the current one is behind. A built view
+         * is never changed: every walk keeps the view it started with, so lexers changed during a walk (even by a nested
+         * query from its callback) are seen by the next query, not by the running one.
+         */
+        [[nodiscard]] std::shared_ptr<const NodeTable> GetNodeTable() const { return AcquireNodeTable(); }
+        /// @brief rebuilds the view right now even if the tree wasn't changed
+        void RebuildNodeTable();
+
         // ===========================================================
         // ================== WORKING WITH LEXERS ====================
         // ===========================================================
 
+        /// @brief visits lexers in the pre-order, the walk stops as soon as the callback returns false
         template<IsLexer Lexer = void, bool IsConst = false>
         void ForEach(ForEachFunctionT<IsConst>&& callback)
         {
-            Params params;
-            ForEachImpl<Lexer, IsConst>(std::forward<ForEachFunctionT<IsConst>>(callback), _fileLexer.get(), params);
+            ForEachImpl<Lexer, IsConst>(this, std::forward<ForEachFunctionT<IsConst>>(callback));
         }
 
         template<IsLexer Lexer = void>
         void ForEach(ForEachFunctionT<true>&& callback) const
         {
-            Params params;
-            ForEachImpl<Lexer, true>(std::forward<ForEachFunctionT<true>>(callback), _fileLexer.get(), params);
+            ForEachImpl<Lexer, true>(this, std::forward<ForEachFunctionT<true>>(callback));
         }
 
         template<IsLexer Lexer = void>
@@ -149,49 +208,45 @@ namespace Ast
         }
 
     private:
+        /// @brief reports a stopped parsing, nothing if it was complete
+        void LogStop(LogCollector& logCollector) const;
+
+        /// @brief the current node table, a new one is built if the lexers tree was changed after the last build
+        [[nodiscard]] std::shared_ptr<NodeTable> AcquireNodeTable() const;
+
         template<IsLexer Lexer = void, bool IsConst = false>
-        static bool ForEachImpl(ForEachFunctionT<IsConst>&& callback, BaseLexer::AdaptiveRawPtr<IsConst> base, Params& params)
+        static void ForEachImpl(AdaptiveRawPtr<IsConst> fileTree, ForEachFunctionT<IsConst>&& callback)
         {
-            if (!base || !callback)
+            if (!callback)
             {
-                return false;
+                return;
             }
 
-            bool isNeedToInvoke = false;
-            if constexpr (std::is_void_v<Lexer>)
-            {
-                isNeedToInvoke = true;
-            }
-            else
-            {
-                if (Lexer::typeName == base->GetLexerType())
-                {
-                    isNeedToInvoke = true;
-                }
-            }
+            const auto pinnedTable = fileTree->AcquireNodeTable();
+            auto& nodeTable = *pinnedTable;
+            const auto nodesCount = static_cast<NodeTable::NodeId>(nodeTable.GetSize());
 
-            if (isNeedToInvoke)
+            NodeTable::TypeTag typeTag = 0;
+            if constexpr (!std::is_void_v<Lexer>)
             {
-                if (!std::invoke(callback, base, params))
-                {
-                    return false;
-                }
+                typeTag = NodeTable::GetTypeTag(Lexer::typeName);
             }
 
-            if (base->HasChildLexers())
+            for (NodeTable::NodeId node = 0; node < nodesCount; ++node)
             {
-                ++params.nesting;
-                for (auto& child : base->GetChildLexers())
+                if constexpr (!std::is_void_v<Lexer>)
                 {
-                    if (child)
+                    if (nodeTable.GetTypeTag(node) != typeTag)
                     {
-                        ForEachImpl<Lexer, IsConst>(std::forward<ForEachFunctionT<IsConst>>(callback), child.get(), params);
+                        continue;
                     }
                 }
-                --params.nesting;
-            }
 
-            return true;
+                if (!std::invoke(callback, nodeTable.GetLexer(node), Params{ nodeTable.GetNesting(node) }))
+                {
+                    return;
+                }
+            }
         }
 
         template<IsLexer Lexer = void, bool IsConst = false>
@@ -220,20 +275,76 @@ namespace Ast
         template<IsLexer Lexer = void, bool IsConst = false>
         [[nodiscard]] static BaseLexer::AdaptivePtr<IsConst> FindFirstByNameImpl(AdaptiveRawPtr<IsConst> fileTree, const String& lexerName)
         {
-            return FindIfImpl<Lexer, IsConst>(fileTree,
-                                              [&lexerName](const BaseLexer* lexer)
-                                              {
-                                                  if (lexer->GetLexerName() == lexerName)
-                                                  {
-                                                      return true;
-                                                  }
-                                                  return false;
-                                              });
+            const auto pinnedTable = fileTree->AcquireNodeTable();
+            auto& nodeTable = *pinnedTable;
+            const auto nodesCount = static_cast<NodeTable::NodeId>(nodeTable.GetSize());
+
+            // a name which was never interned can't belong to any lexer
+            const auto name = Symbol::Find(lexerName.ToStringView());
+            if (name.IsEmpty() && !lexerName.IsEmpty())
+            {
+                return {};
+            }
+
+            NodeTable::TypeTag typeTag = 0;
+            if constexpr (!std::is_void_v<Lexer>)
+            {
+                typeTag = NodeTable::GetTypeTag(Lexer::typeName);
+            }
+
+            for (NodeTable::NodeId node = 0; node < nodesCount; ++node)
+            {
+                if constexpr (!std::is_void_v<Lexer>)
+                {
+                    if (nodeTable.GetTypeTag(node) != typeTag)
+                    {
+                        continue;
+                    }
+                }
+
+                if (nodeTable.GetNameSymbol(node) == name)
+                {
+                    return nodeTable.GetLexer(node);
+                }
+            }
+
+            return {};
         }
 
     private:
+        /// @brief the node table and the version of the lexers tree it was built for, every copy of the tree gets its own lock
+        struct NodeTableState
+        {
+            inline static constexpr std::uint64_t notBuilt = std::numeric_limits<std::uint64_t>::max();
+
+            NodeTableState() = default;
+            NodeTableState(const NodeTableState& other)
+            {
+                const std::lock_guard lock{ other.mutex };
+                table = other.table;
+                builtVersion = other.builtVersion;
+            }
+            NodeTableState& operator=(const NodeTableState& other)
+            {
+                if (this != &other)
+                {
+                    const std::scoped_lock lock{ mutex, other.mutex };
+                    table = other.table;
+                    builtVersion = other.builtVersion;
+                }
+                return *this;
+            }
+
+            mutable std::mutex mutex;
+            std::shared_ptr<NodeTable> table = std::make_shared<NodeTable>(); // never changed after the build, only replaced
+            std::uint64_t builtVersion = notBuilt;
+        };
+
+    private:
+        LexerSideTables::Ptr _sideTables;
         FileLexer::Ptr _fileLexer;
         ContentStream::Ptr _fileReader;
+        mutable NodeTableState _nodeTableState;
     };
 
 } // namespace Ast
\ No newline at end of file
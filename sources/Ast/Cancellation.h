@@ -0,0 +1,50 @@
+// Copyright (c) 2024 Valerii Koniushenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "CommonTypes.h"
+
+#include <boost/smart_ptr/intrusive_ptr.hpp>
+#include <boost/smart_ptr/intrusive_ref_counter.hpp>
+
+#include <atomic>
+
+namespace Ast
+{
+
+    /**
+     * @brief Stops parsings from another thread, e.g. when the whole job is cancelled
+     * @details The cancellation is cooperative: a parser checks the token between its steps (see ParseOptions::cancellationToken),
+     * so a lexer being validated is finished first. One token may be shared by any number of parsings.
+     */
+    class CancellationToken final : public boost::intrusive_ref_counter<CancellationToken>
+    {
+    public:
+        AST_CLASS(CancellationToken)
+
+        void Cancel() noexcept { _isCancelled.store(true, std::memory_order_relaxed); }
+        [[nodiscard]] bool IsCancelled() const noexcept { return _isCancelled.load(std::memory_order_relaxed); }
+
+    private:
+        std::atomic<bool> _isCancelled = false;
+    };
+
+} // namespace Ast
\ No newline at end of file
@@ -23,6 +23,7 @@
 #include "Core/String.h"
 
 #include <cstddef>
+#include <string_view>
 
 #define AST_CLASS(className)                                                                                                                         \
 public:                                                                                                                                              \
@@ -40,5 +41,6 @@ namespace Ast
     using Size = std::size_t;
     using Index = long long;
     using String = Core::BaseString<Char>;
+    using StringView = std::basic_string_view<Char>;
 
 } // namespace Ast
\ No newline at end of file
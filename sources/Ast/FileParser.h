@@ -33,7 +33,8 @@ namespace Ast
         FileParser() = default;
         ~FileParser() override = default;
 
-        virtual bool Parse(const ContentStream::Ptr& content, LogCollector& logCollector) = 0;
+        /// @brief lexers are created over the reader of the side tables and keep their cold data there
+        virtual bool Parse(const LexerSideTables::Ptr& sideTables, LogCollector& logCollector) = 0;
         virtual void IterateOverLexers(std::function<bool(BaseLexer*)>&& callback) = 0;
 
         // TODO: add 'const'
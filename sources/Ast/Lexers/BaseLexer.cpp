@@ -22,6 +22,7 @@
 
 #include "../Readers/ContentStream.h"
 #include "Ast/LogCollector.h"
+#include "Ast/MemoryUsage.h"
 #include "Ast/Rule.h"
 #include "Ast/Utils/Scopes.h"
 #include "Core/Assert.h"
@@ -29,19 +30,72 @@
 namespace Ast
 {
 
+    namespace
+    {
+        const Symbol& GetDefaultLexerName()
+        {
+            static const Symbol name("none"_atom);
+            return name;
+        }
+    } // namespace
+
+    BaseLexer::~BaseLexer()
+    {
+        for (auto&& child : _childLexers)
+        {
+            if (child)
+            {
+                child->_parentLexer = nullptr;
+            }
+        }
+    }
+
     bool BaseLexer::operator==(const BaseLexer& other) const
     {
-        return other._reader == _reader && other._token.beginData == _token.beginData && other._token.endData == _token.endData &&
-               other._lexerName == _lexerName && other._parentLexer == _parentLexer;
+        if (other._parentLexer != _parentLexer || other._lexerName != _lexerName || other.GetReader() != GetReader())
+        {
+            return false;
+        }
+
+        const auto& token = GetTokenReader();
+        const auto& otherToken = other.GetTokenReader();
+        return otherToken.beginData == token.beginData && otherToken.endData == token.endData;
     }
 
     void BaseLexer::SetToken(const TokenReader& token)
     {
-        _token = token;
+        GetColdData<TokenReader>() = token;
+    }
+
+    const TokenReader& BaseLexer::GetTokenReader() const noexcept
+    {
+        static const TokenReader emptyToken;
+
+        const auto* token = FindColdData<TokenReader>();
+        return token ? *token : emptyToken;
+    }
+
+    std::optional<BaseLexer::Marker> BaseLexer::GetMark() const
+    {
+        if (const auto* marker = FindColdData<Marker>())
+        {
+            return *marker;
+        }
+        return std::nullopt;
+    }
+
+    void BaseLexer::SetMark(Marker&& marker)
+    {
+        GetColdData<Marker>() = std::move(marker);
     }
 
     bool BaseLexer::Validate(LogCollector& logCollector)
     {
+        if (_sideTables->IsStopRequested())
+        {
+            return false;
+        }
+
         if (!DoValidate(logCollector))
         {
             return false;
@@ -59,15 +113,46 @@ namespace Ast
             return false;
         }
 
-        logCollector.AddLog(
-            { String::Format("successfull parsing of the {}: '{}'", _lexerType.CStr(), _lexerName.CStr()), LogCollector::LogType::Success });
+        // the scope search may have spent the rest of the budget on unbalanced brackets
+        if (_sideTables->IsStopRequested())
+        {
+            return false;
+        }
+
+        if (_sideTables->GetParseOptions().lazyDetails)
+        {
+            DoReserveDetails();
+        }
+        else
+        {
+            AnalyzeDetails(logCollector);
+        }
+
+        logCollector.AddLog(LogCollector::LogLine::MakeEvent(LogCollector::EventCode::LexerParsed, LogCollector::LogType::Success,
+                                                             { _lexerType, _lexerName }, _openScope.line));
 
         return IsValid();
     }
 
+    void BaseLexer::AnalyzeDetails(LogCollector& logCollector) const
+    {
+        // the details are a lazily filled cache, so they are computed from const accessors too
+        std::call_once(_detailsAnalyzed, [this, &logCollector]() { const_cast<BaseLexer*>(this)->DoAnalyzeDetails(logCollector); });
+    }
+
+    void BaseLexer::EnsureDetails() const
+    {
+        std::call_once(_detailsAnalyzed,
+                       [this]()
+                       {
+                           LogCollector logCollector;
+                           const_cast<BaseLexer*>(this)->DoAnalyzeDetails(logCollector);
+                       });
+    }
+
     bool BaseLexer::IsValid() const
     {
-        return !_lexerType.IsEmpty() && !_lexerName.IsEmpty() && _reader;
+        return !_lexerType.IsEmpty() && !_lexerName.IsEmpty() && GetReader();
     }
 
     bool BaseLexer::IsCorrespondingToRule(const Rule& rule, LogCollector& logCollector, const char* additionalMessage /* = nullptr*/) const
@@ -101,13 +186,14 @@ namespace Ast
                 auto it = std::find_if(_childLexers.cbegin(), _childLexers.cend(),
                                        [&child](const auto& lexer)
                                        {
-                                           return child->GetLexerName() == lexer->GetLexerName();
+                                           return child->_lexerName == lexer->_lexerName;
                                        });
 
                 if (Verify(it == _childLexers.cend(), "Such child already exists"))
                 {
                     _childLexers.push_back(child);
                     child->_parentLexer = this;
+                    child->MarkTreeChanged();
                 }
             }
         }
@@ -119,27 +205,46 @@ namespace Ast
             auto it = std::find_if(_childLexers.cbegin(), _childLexers.cend(),
                                    [&child](const auto& lexer)
                                    {
-                                       return child->GetLexerName() == lexer->GetLexerName();
+                                       return child->_lexerName == lexer->_lexerName;
                                    });
 
             if (Verify(it == _childLexers.cend(), "Such child already exists"))
             {
                 _childLexers.push_back(child);
                 child->_parentLexer = this;
+                child->MarkTreeChanged();
             }
         }
     }
 
+    std::vector<BaseLexer::Ptr> BaseLexer::DetachChildLexers()
+    {
+        std::vector<Ptr> children = std::move(_childLexers);
+        _childLexers.clear();
+        MarkTreeChanged();
+
+        for (auto&& child : children)
+        {
+            if (child)
+            {
+                child->_parentLexer = nullptr;
+                child->MarkTreeChanged();
+            }
+        }
+
+        return children;
+    }
+
     bool BaseLexer::IsContainLexer(const BaseLexer* other, bool isInItsScope /* = false*/) const
     {
-        if (Verify(other) && Verify(_closeScope.has_value()) && Verify(_openScope.has_value()) && Verify(other->_closeScope.has_value()) &&
-            Verify(other->_openScope.has_value()))
+        if (Verify(other) && Verify(_closeScope.string) && Verify(_openScope.string) && Verify(other->_closeScope.string) &&
+            Verify(other->_openScope.string))
         {
-            if (_openScope->string < other->_openScope->string && _closeScope->string > other->_closeScope->string)
+            if (_openScope.string < other->_openScope.string && _closeScope.string > other->_closeScope.string)
             {
                 if (isInItsScope)
                 {
-                    return !Utils::HasUnclosedBracket(_openScope->string, other->_openScope->string, '}', '{');
+                    return !Utils::HasUnclosedBracket(*GetReader(), _openScope.string, other->_openScope.string, '}', '{');
                 }
 
                 return true;
@@ -148,22 +253,60 @@ namespace Ast
         return false;
     }
 
+    void BaseLexer::CollectMemoryUsage(MemoryUsageInfo& usage) const
+    {
+        usage.lexers += sizeof(BaseLexer);
+        usage.childPointers += MemoryUsageInfo::GetHeapSize(_childLexers);
+
+        if (const auto* marker = FindColdData<Marker>())
+        {
+            usage.details += MemoryUsageInfo::GetHeapSize(marker->params);
+            usage.strings += MemoryUsageInfo::GetHeapSize(marker->rule);
+            for (auto&& param : marker->params)
+            {
+                usage.strings += MemoryUsageInfo::GetHeapSize(param);
+            }
+        }
+    }
+
     void BaseLexer::Clear()
     {
-        _token.Clear();
-        _openScope.reset();
-        _closeScope.reset();
-        _lexerName.Clear();
-        _parentLexer.reset();
-        _childLexers.clear();
+        if (auto* token = _sideTables->Find<TokenReader>(_nodeId))
+        {
+            token->Clear();
+        }
+        _openScope = {};
+        _closeScope = {};
+        _lexerName = {};
+        MarkTreeChanged();
+        _parentLexer = nullptr;
+        DetachChildLexers();
     }
 
-    BaseLexer::BaseLexer(const ContentStream::Ptr& reader, const String& type)
-        : _reader{ reader },
-          _lexerType{ type }
+    void BaseLexer::MarkTreeChanged() noexcept
     {
-        Assert(!!_reader);
+        // a subtree attached from another tree may still have its own tables, so every distinct one on the way up is bumped
+        const LexerSideTables* lastMarked = nullptr;
+        for (auto* lexer = this; lexer; lexer = lexer->_parentLexer)
+        {
+            if (lexer->_sideTables && lexer->_sideTables.get() != lastMarked)
+            {
+                lexer->_sideTables->MarkTreeChanged();
+                lastMarked = lexer->_sideTables.get();
+            }
+        }
+    }
+
+    BaseLexer::BaseLexer(const ContentStream::Ptr& reader, const LexerSideTables::Ptr& sideTables, const String& type)
+        : _sideTables{ sideTables ? sideTables : LexerSideTables::Create(reader) },
+          _lexerType{ type },
+          _lexerName{ GetDefaultLexerName() }
+    {
+        Assert(!!reader);
+        Assert(_sideTables->GetReader() == reader);
         Assert(!_lexerType.IsEmpty());
+
+        _nodeId = _sideTables->AllocateNode();
     }
 
 } // namespace Ast
\ No newline at end of file
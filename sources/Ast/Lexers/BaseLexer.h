@@ -23,16 +23,22 @@
 #include "../CommonTypes.h"
 #include "../Readers/ContentStream.h"
 #include "../Readers/Token.h"
+#include "../Symbol.h"
+#include "LexerSideTables.h"
 #include "Utils/CopyableAndMoveableBehaviour.h"
 
 #include <boost/smart_ptr/intrusive_ptr.hpp>
 #include <boost/smart_ptr/intrusive_ref_counter.hpp>
 
+#include <mutex>
+#include <utility>
+
 namespace Ast
 {
     class Rule;
     class LogCollector;
     class BaseLexer;
+    struct MemoryUsageInfo;
 
     template<class T>
     concept IsLexer = (std::derived_from<T, BaseLexer> && requires(T) {
@@ -60,6 +66,14 @@ namespace Ast
      * // Correct example #2
      * boost::intrusive_ptr<SomeDerivedLexer> lexer = new SomeDerivedLexer;
      * @endcode
+     * Ownership goes from a parent to its children only: a parent keeps its children alive, a child refers to its parent
+     * by a plain pointer. When a lexer dies its children are detached, so a child held outside of a tree never points to
+     * a released parent. That's why a lexer can't be copied: a copy would share the children and detach them from the
+     * original in its destructor. It can't be moved either, the once_flag of the deferred details isn't movable, and the
+     * children point to the parent by its address. Lexers are always passed by Ptr, despite the CopyableAndMoveable base.
+     *
+     * A lexer object is only a hot header: type, name, scopes and links. Everything else (the token, a marker and the
+     * details of derived lexers) lives in the LexerSideTables of the tree and is reached by the node id of the lexer.
      */
     class BaseLexer : public ::Utils::CopyableAndMoveable, public boost::intrusive_ref_counter<BaseLexer>
     {
@@ -92,7 +106,11 @@ namespace Ast
         };
 
     public:
-        ~BaseLexer() override = default;
+        BaseLexer(const BaseLexer&) = delete;
+        BaseLexer& operator=(const BaseLexer&) = delete;
+        BaseLexer(BaseLexer&&) = delete;
+        BaseLexer& operator=(BaseLexer&&) = delete;
+        ~BaseLexer() override;
 
         [[nodiscard]] bool operator==(const BaseLexer&) const;
 
@@ -100,12 +118,20 @@ namespace Ast
         bool Validate(LogCollector& logCollector);
         [[nodiscard]] bool IsValid() const;
 
+        /**
+         * @brief Runs the detail passes of the lexer (e.g. fields of a class) if they weren't run yet
+         * @details Validate() runs them right away unless ParseOptions::lazyDetails is set, otherwise the accessors of the
+         * details run them on the first call. Either way they run once, concurrent callers wait for the first one.
+         */
+        void AnalyzeDetails(LogCollector& logCollector) const;
+
         bool IsCorrespondingToRule(const Rule& rule, LogCollector& logCollector, const char* additionalMessage = nullptr) const;
 
         template<IsLexer Lexer>
         [[nodiscard]] bool IsTypeOf() const noexcept
         {
-            return _lexerType == Lexer::typeName && dynamic_cast<const Lexer*>(this) != nullptr;
+            static const Symbol lexerType(Lexer::typeName);
+            return _lexerType == lexerType && dynamic_cast<const Lexer*>(this) != nullptr;
         }
 
         template<IsLexer Lexer>
@@ -130,8 +156,10 @@ namespace Ast
 
         [[nodiscard]] bool WasModified() const noexcept { return _modifierParams.wasModified; }
 
-        [[nodiscard]] String GetLexerName() const noexcept { return _lexerName; }
-        [[nodiscard]] String GetLexerType() const noexcept { return _lexerType; }
+        [[nodiscard]] const String& GetLexerName() const noexcept { return _lexerName.GetString(); }
+        [[nodiscard]] const String& GetLexerType() const noexcept { return _lexerType.GetString(); }
+        [[nodiscard]] Symbol GetLexerNameSymbol() const noexcept { return _lexerName; }
+        [[nodiscard]] Symbol GetLexerTypeSymbol() const noexcept { return _lexerType; }
 
         // ================================================================
         // ================== WORKING WITH LEXERS TREE ====================
@@ -178,25 +206,43 @@ namespace Ast
         void TryToSetParent(const Ptr& parent);
         void TryToSetAsChild(const Ptr& child);
         void ForceSetAsChild(const Ptr& child);
+
+        /// @brief releases children from this lexer and returns them, every returned child has no parent anymore
+        std::vector<Ptr> DetachChildLexers();
         [[nodiscard]] bool IsContainLexer(const BaseLexer* other, bool isInItsScope = false) const;
         [[nodiscard]] bool IsContainLexer(const Ptr& other, bool isInItsScope = false) const { return IsContainLexer(other.get(), isInItsScope); }
-        [[nodiscard]] std::optional<LineToken> GetOpenScope() const noexcept { return _openScope; }
-        [[nodiscard]] std::optional<LineToken> GetCloseScope() const noexcept { return _closeScope; }
+        [[nodiscard]] std::optional<LineToken> GetOpenScope() const noexcept
+        {
+            return _openScope.string ? std::make_optional(_openScope) : std::nullopt;
+        }
+        [[nodiscard]] std::optional<LineToken> GetCloseScope() const noexcept
+        {
+            return _closeScope.string ? std::make_optional(_closeScope) : std::nullopt;
+        }
 
         [[nodiscard]] long long GetDistanceToLexer(const BaseLexer* lexer) const noexcept
         {
-            return Verify(lexer && lexer->GetOpenScope() && _closeScope) ? lexer->_openScope->string - _closeScope->string : 0;
+            return Verify(lexer && lexer->_openScope.string && _closeScope.string) ? lexer->_openScope.string - _closeScope.string : 0;
         }
 
         [[nodiscard]] long long GetDistanceToLexer(const Ptr& lexer) const noexcept { return GetDistanceToLexer(lexer.get()); }
 
         void Clear();
 
-        [[nodiscard]] ContentStream::Ptr GetReader() { return _reader; }
-        [[nodiscard]] ContentStream::CPtr GetReader() const { return _reader; }
-        [[nodiscard]] TokenReader GetTokenReader() const noexcept { return _token; }
-        [[nodiscard]] std::optional<Marker> GetMark() const noexcept { return _marking; }
-        [[nodiscard]] bool IsMarked() const noexcept { return _marking.has_value(); }
+        [[nodiscard]] ContentStream::Ptr GetReader() { return _sideTables->GetReader(); }
+        [[nodiscard]] ContentStream::CPtr GetReader() const { return std::as_const(*_sideTables).GetReader(); }
+        [[nodiscard]] const TokenReader& GetTokenReader() const noexcept;
+        [[nodiscard]] std::optional<Marker> GetMark() const;
+        /// @brief the marker without copying, nullptr if the lexer isn't marked
+        [[nodiscard]] const Marker* FindMark() const noexcept { return FindColdData<Marker>(); }
+        [[nodiscard]] bool IsMarked() const noexcept { return FindColdData<Marker>() != nullptr; }
+
+        [[nodiscard]] LexerSideTables::Ptr GetSideTables() { return _sideTables; }
+        [[nodiscard]] LexerSideTables::CPtr GetSideTables() const { return _sideTables; }
+        [[nodiscard]] LexerSideTables::NodeId GetNodeId() const noexcept { return _nodeId; }
+
+        /// @brief adds bytes held by this lexer (without its children) to the 'usage'
+        virtual void CollectMemoryUsage(MemoryUsageInfo& usage) const;
 
     protected:
         virtual bool DoValidate(LogCollector& logCollector) = 0;
@@ -204,23 +250,49 @@ namespace Ast
         virtual bool DoMarkingValidate(LogCollector& logCollector) { return true; }
         virtual bool DoPostValidate(LogCollector& logCollector) { return true; }
 
-        BaseLexer(const ContentStream::Ptr& reader, const String& type);
+        /// @brief passes which aren't needed to build the tree, they may be deferred, see AnalyzeDetails()
+        virtual void DoAnalyzeDetails(LogCollector& logCollector) {}
+        /// @brief adds the records filled by DoAnalyzeDetails(), so deferred passes never change the layout of the side tables
+        virtual void DoReserveDetails() {}
+
+        /// @brief for the accessors of the details, the errors of deferred passes are dropped
+        void EnsureDetails() const;
+
+        /// @param sideTables storage of the tree the lexer belongs to, a standalone lexer gets its own one
+        BaseLexer(const ContentStream::Ptr& reader, const LexerSideTables::Ptr& sideTables, const String& type);
+
+        void SetMark(Marker&& marker);
+
+        /// @brief tells the views built over the tree (e.g. the node table of ASTFileTree) that its shape or names changed
+        void MarkTreeChanged() noexcept;
+
+        template<class Record>
+        [[nodiscard]] const Record* FindColdData() const noexcept
+        {
+            return std::as_const(*_sideTables).template Find<Record>(_nodeId);
+        }
+
+        template<class Record>
+        [[nodiscard]] Record& GetColdData()
+        {
+            return _sideTables->template Get<Record>(_nodeId);
+        }
 
     protected:
         ModifierParams _modifierParams;
-        TokenReader _token;
-        ContentStream::Ptr _reader;
-
-        std::optional<Marker> _marking;
+        LexerSideTables::NodeId _nodeId = 0;
+        LexerSideTables::Ptr _sideTables;
 
-        std::optional<LineToken> _openScope;
-        std::optional<LineToken> _closeScope;
+        LineToken _openScope;
+        LineToken _closeScope;
 
-        const String _lexerType;
-        String _lexerName = "none"_atom;
-        Ptr _parentLexer;
+        const Symbol _lexerType;
+        Symbol _lexerName;
+        BaseLexer* _parentLexer = nullptr; // non-owning, see the class description
         std::vector<Ptr> _childLexers;
 
+        mutable std::once_flag _detailsAnalyzed; // makes the lexer non-movable, see the class description
+
     private:
         template<IsLexer Lexer, bool IsConst = false>
         [[nodiscard]] static std::vector<AdaptivePtr<IsConst>> GetChildLexersImpl(AdaptiveRawPtr<IsConst> lexer)
@@ -246,7 +318,7 @@ namespace Ast
             {
                 while (i->HasParent())
                 {
-                    i = i->GetParentLexer().get();
+                    i = i->_parentLexer;
                 }
             }
             return { i };
@@ -20,29 +20,57 @@
 
 #include "FileLexer.h"
 
+#include "Ast/MemoryUsage.h"
 #include "Ast/Readers/FileReader.h"
 
 namespace Ast
 {
 
-    FileLexer::FileLexer(const ContentStream::Ptr& fileReader)
-        : BaseLexer(fileReader, typeName)
+    namespace
+    {
+        // '#pragma +once' without running a regex over the whole content
+        bool FindPragmaOnce(const String& data)
+        {
+            const StringView content(data.c_str(), data.Size());
+            constexpr StringView pragma = "#pragma";
+            constexpr StringView once = "once";
+            for (auto i = content.find(pragma); i != StringView::npos; i = content.find(pragma, i + 1))
+            {
+                auto rest = content.substr(i + pragma.size());
+                const auto spaces = rest.find_first_not_of(' ');
+                if (spaces != 0 && spaces != StringView::npos && rest.substr(spaces).starts_with(once))
+                {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+    } // namespace
+
+    FileLexer::FileLexer(const ContentStream::Ptr& fileReader, const LexerSideTables::Ptr& sideTables)
+        : BaseLexer(fileReader, sideTables, typeName)
     {
     }
 
     bool FileLexer::DoValidate(LogCollector& logCollector)
     {
-        if (const auto reader = boost::dynamic_pointer_cast<const FileReader>(_reader))
+        const auto reader = GetReader();
+        if (const auto fileReader = boost::dynamic_pointer_cast<const FileReader>(reader))
         {
-            _lexerName = reader->GetPathToFile().string();
+            _lexerName = Symbol(String(fileReader->GetPathToFile().string()));
+            MarkTreeChanged();
         }
 
-        if (!_reader->Data().FindRegex("#pragma +once", 0, std::regex_constants::format_first_only).empty())
-        {
-            _hasPragmaOnce = true;
-        }
+        _hasPragmaOnce = FindPragmaOnce(reader->Data());
 
         return true;
     }
 
+    void FileLexer::CollectMemoryUsage(MemoryUsageInfo& usage) const
+    {
+        BaseLexer::CollectMemoryUsage(usage);
+        usage.lexers += sizeof(FileLexer) - sizeof(BaseLexer);
+    }
+
 } // namespace Ast
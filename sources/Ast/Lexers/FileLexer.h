@@ -38,18 +38,20 @@ namespace Ast
         bool DoValidate(LogCollector& logCollector) override;
         [[nodiscard]] bool HasPragmaOnce() const noexcept { return _hasPragmaOnce; }
 
-        [[nodiscard]] static Ptr Create(const ContentStream::Ptr& fileReader)
+        [[nodiscard]] static Ptr Create(const ContentStream::Ptr& fileReader, const LexerSideTables::Ptr& sideTables = nullptr)
         {
-            return { new FileLexer(fileReader) };
+            return { new FileLexer(fileReader, sideTables) };
         }
 
-        [[nodiscard]] String GetFileName() const
+        [[nodiscard]] const String& GetFileName() const
         {
-            return _lexerName;
+            return _lexerName.GetString();
         }
 
+        void CollectMemoryUsage(MemoryUsageInfo& usage) const override;
+
     private:
-        explicit FileLexer(const ContentStream::Ptr& fileReader);
+        FileLexer(const ContentStream::Ptr& fileReader, const LexerSideTables::Ptr& sideTables);
 
     private:
         bool _hasPragmaOnce = false;
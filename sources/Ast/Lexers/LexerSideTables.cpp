@@ -0,0 +1,83 @@
+// Copyright (c) 2024 Valerii Koniushenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "LexerSideTables.h"
+
+#include "Core/Assert.h"
+
+namespace Ast
+{
+
+    LexerSideTables::LexerSideTables(const ContentStream::Ptr& reader)
+        : _reader{ reader }
+    {
+        Assert(!!_reader);
+    }
+
+    void LexerSideTables::SetParseOptions(const ParseOptions& options)
+    {
+        _parseOptions = options;
+        _stopReason.store(StopReason::None, std::memory_order_relaxed);
+        _deadline = options.timeBudget.count() > 0 ? std::chrono::steady_clock::now() + options.timeBudget
+                                                   : std::chrono::steady_clock::time_point::max();
+    }
+
+    bool LexerSideTables::IsStopRequested() const noexcept
+    {
+        if (GetStopReason() != StopReason::None)
+        {
+            return true;
+        }
+
+        auto reason = StopReason::None;
+        if (_parseOptions.cancellationToken && _parseOptions.cancellationToken->IsCancelled())
+        {
+            reason = StopReason::Cancelled;
+        }
+        else if (_deadline != std::chrono::steady_clock::time_point::max() && std::chrono::steady_clock::now() >= _deadline)
+        {
+            reason = StopReason::TimeBudget;
+        }
+
+        if (reason == StopReason::None)
+        {
+            return false;
+        }
+
+        // the first found reason wins
+        auto expected = StopReason::None;
+        _stopReason.compare_exchange_strong(expected, reason, std::memory_order_relaxed);
+        return true;
+    }
+
+    Size LexerSideTables::GetMemoryUsage() const noexcept
+    {
+        Size bytes = sizeof(LexerSideTables) + _columns.capacity() * sizeof(std::unique_ptr<IColumn>);
+        for (auto&& column : _columns)
+        {
+            if (column)
+            {
+                bytes += column->GetMemoryUsage();
+            }
+        }
+        return bytes;
+    }
+
+} // namespace Ast
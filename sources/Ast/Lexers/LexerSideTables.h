@@ -0,0 +1,203 @@
+// Copyright (c) 2024 Valerii Koniushenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "../CommonTypes.h"
+#include "../ParseOptions.h"
+#include "../Readers/ContentStream.h"
+#include "Utils/CopyableAndMoveableBehaviour.h"
+
+#include <boost/smart_ptr/intrusive_ptr.hpp>
+#include <boost/smart_ptr/intrusive_ref_counter.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace Ast
+{
+
+    /**
+     * @brief Per-tree storage of the cold lexer data
+     * @details A lexer keeps only a small fixed-size header (type, name, scopes and links) and reaches everything else
+     * (tokens, markers, fields, parents, constants...) by its node id. Every kind of record lives in its own column, so
+     * walks over the lexers don't pull the variable-length data into the cache.
+     * @code
+     * auto sideTables = LexerSideTables::Create(reader);
+     * const auto node = sideTables->AllocateNode();
+     * sideTables->Get<SomeRecord>(node).value = 10;
+     * if (const auto* record = sideTables->Find<SomeRecord>(node)) { ... }
+     * @endcode
+     */
+    class LexerSideTables final : public ::Utils::CopyableAndMoveable, public boost::intrusive_ref_counter<LexerSideTables>
+    {
+    public:
+        AST_CLASS(LexerSideTables)
+
+        using NodeId = std::uint32_t;
+
+        enum class StopReason : std::uint8_t
+        {
+            None,
+            TimeBudget,
+            Cancelled
+        };
+
+    public:
+        ~LexerSideTables() override = default;
+
+        [[nodiscard]] static Ptr Create(const ContentStream::Ptr& reader)
+        {
+            return { new LexerSideTables(reader) };
+        }
+
+        [[nodiscard]] NodeId AllocateNode() noexcept { return _nodesCount++; }
+        [[nodiscard]] NodeId GetNodesCount() const noexcept { return _nodesCount; }
+
+        [[nodiscard]] ContentStream::Ptr GetReader() { return _reader; }
+        [[nodiscard]] ContentStream::CPtr GetReader() const { return _reader; }
+
+        /// @brief options of the parsing which fills the tables, lexers check them during validation
+        [[nodiscard]] const ParseOptions& GetParseOptions() const noexcept { return _parseOptions; }
+        /// @brief starts the time budget of the options
+        void SetParseOptions(const ParseOptions& options);
+
+        /**
+         * @brief Checks the time budget and the cancellation token of the parse options
+         * @details Once true it stays true until the next SetParseOptions, so the steps after the first stopped one
+         * return right away. Meant to be called between the steps of the parsing, not per character. The reason is
+         * atomic, so the check is safe from the concurrent passes over the same tree.
+         */
+        [[nodiscard]] bool IsStopRequested() const noexcept;
+        [[nodiscard]] StopReason GetStopReason() const noexcept { return _stopReason.load(std::memory_order_relaxed); }
+
+        /// @brief version of the lexers tree shape and names, bumped by every change of them, views built over the tree compare it
+        [[nodiscard]] std::uint64_t GetTreeVersion() const noexcept { return _treeVersion.load(std::memory_order_acquire); }
+        void MarkTreeChanged() noexcept { _treeVersion.fetch_add(1, std::memory_order_acq_rel); }
+
+        template<class Record>
+        [[nodiscard]] Record* Find(NodeId node) noexcept
+        {
+            return FindImpl<Record>(this, node);
+        }
+
+        template<class Record>
+        [[nodiscard]] const Record* Find(NodeId node) const noexcept
+        {
+            return FindImpl<Record, true>(this, node);
+        }
+
+        /// @brief returns the record of the node, a default one is added if the node has no such record yet
+        template<class Record>
+        [[nodiscard]] Record& Get(NodeId node)
+        {
+            const auto index = GetColumnIndex<Record>();
+            if (index >= _columns.size())
+            {
+                _columns.resize(index + 1);
+            }
+            if (!_columns[index])
+            {
+                _columns[index] = std::make_unique<Column<Record>>();
+            }
+
+            auto& column = static_cast<Column<Record>&>(*_columns[index]);
+            if (node >= column.rows.size())
+            {
+                column.rows.resize(node + 1, Column<Record>::noRow);
+            }
+            if (column.rows[node] == Column<Record>::noRow)
+            {
+                column.rows[node] = static_cast<std::uint32_t>(column.records.size());
+                column.records.emplace_back();
+            }
+
+            return column.records[column.rows[node]];
+        }
+
+        /// @brief bytes held by the columns themselves, heap data inside of records is accounted by the lexers
+        [[nodiscard]] Size GetMemoryUsage() const noexcept;
+
+    private:
+        struct IColumn
+        {
+            virtual ~IColumn() = default;
+            [[nodiscard]] virtual Size GetMemoryUsage() const noexcept = 0;
+        };
+
+        template<class Record>
+        struct Column final : IColumn
+        {
+            inline static constexpr std::uint32_t noRow = std::numeric_limits<std::uint32_t>::max();
+
+            std::vector<std::uint32_t> rows; // node id -> index in the 'records'
+            std::vector<Record> records;
+
+            [[nodiscard]] Size GetMemoryUsage() const noexcept override
+            {
+                return rows.capacity() * sizeof(std::uint32_t) + records.capacity() * sizeof(Record);
+            }
+        };
+
+    private:
+        explicit LexerSideTables(const ContentStream::Ptr& reader);
+
+        template<class Record>
+        [[nodiscard]] static Size GetColumnIndex() noexcept
+        {
+            static const Size index = _columnsCount++;
+            return index;
+        }
+
+        template<class Record, bool IsConst = false>
+        [[nodiscard]] static std::conditional_t<IsConst, const Record, Record>* FindImpl(AdaptiveRawPtr<IsConst> sideTables, NodeId node) noexcept
+        {
+            const auto index = GetColumnIndex<Record>();
+            if (index >= sideTables->_columns.size() || !sideTables->_columns[index])
+            {
+                return nullptr;
+            }
+
+            auto& column = static_cast<std::conditional_t<IsConst, const Column<Record>, Column<Record>>&>(*sideTables->_columns[index]);
+            if (node >= column.rows.size() || column.rows[node] == Column<Record>::noRow)
+            {
+                return nullptr;
+            }
+
+            return &column.records[column.rows[node]];
+        }
+
+    private:
+        inline static std::atomic<Size> _columnsCount = 0;
+
+        ContentStream::Ptr _reader;
+        ParseOptions _parseOptions;
+        std::chrono::steady_clock::time_point _deadline = std::chrono::steady_clock::time_point::max();
+        mutable std::atomic<StopReason> _stopReason = StopReason::None;
+        std::atomic<std::uint64_t> _treeVersion = 0;
+        NodeId _nodesCount = 0;
+        std::vector<std::unique_ptr<IColumn>> _columns;
+    };
+
+} // namespace Ast
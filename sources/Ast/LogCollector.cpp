@@ -20,17 +20,486 @@
 
 #include "LogCollector.h"
 
+#include "MemoryUsage.h"
+
+#include <algorithm>
+#include <tuple>
+#include <utility>
+
 namespace Ast
 {
 
-    void LogCollector::AddLog(const LogLine& logLine)
+    namespace
+    {
+        /// @brief the file of the innermost FileScope of the thread
+        thread_local Symbol currentFile;
+
+        /// @brief in the aggregation mode producers try to collect the pending records after every such count of them
+        constexpr Size aggregationCollectPeriod = 1024;
+
+        [[nodiscard]] bool IsDigit(String::CharT ch) noexcept
+        {
+            return ch >= '0' && ch <= '9';
+        }
+
+        /// @brief the message with runs of digits and the text in single quotes replaced by {}
+        [[nodiscard]] String MakePattern(StringView message)
+        {
+            std::basic_string<String::CharT> pattern;
+            pattern.reserve(message.size());
+            for (Size i = 0; i < message.size(); ++i)
+            {
+                if (IsDigit(message[i]))
+                {
+                    while (i + 1 < message.size() && IsDigit(message[i + 1]))
+                    {
+                        ++i;
+                    }
+                    pattern += "{}";
+                }
+                else if (message[i] == '\'' && message.find('\'', i + 1) != StringView::npos)
+                {
+                    pattern += "'{}'";
+                    i = message.find('\'', i + 1);
+                }
+                else
+                {
+                    pattern += message[i];
+                }
+            }
+            return String(pattern.data(), pattern.size());
+        }
+    } // namespace
+
+    LogCollector::FileScope::FileScope(Symbol file)
+        : _previous(std::exchange(currentFile, file))
+    {
+    }
+
+    LogCollector::FileScope::~FileScope()
+    {
+        currentFile = _previous;
+    }
+
+    String LogCollector::LogLine::Render() const
+    {
+        switch (code)
+        {
+        case EventCode::LexerParsed:
+            return String::Format("successfull parsing of the {}: '{}'", arguments[0].c_str(), arguments[1].c_str());
+        case EventCode::ScopesBound:
+            return String::Format("Successfully was build binding between lexers at file: '{}'", file.IsEmpty() ? "none" : file.c_str());
+        default:
+            return message;
+        }
+    }
+
+    String LogCollector::LogGroup::Render() const
+    {
+        String summary = first.Render();
+        if (count < 2)
+        {
+            return summary;
+        }
+
+        summary += String::Format(" [{} times, e.g. at", count);
+        for (auto&& sample : samples)
+        {
+            summary += String::Format(" {}:{}", sample.file.IsEmpty() ? "none" : sample.file.c_str(), sample.line);
+        }
+        summary += ']';
+        return summary;
+    }
+
+    LogCollector::LogCollector(const LogCollector& other)
+        : Utils::CopyableAndMoveable(other)
+    {
+        *this = other;
+    }
+
+    LogCollector::LogCollector(LogCollector&& other) noexcept
+        : Utils::CopyableAndMoveable(std::move(other))
+    {
+        *this = std::move(other);
+    }
+
+    LogCollector::~LogCollector()
+    {
+        StopAsyncDispatch();
+        Reset();
+    }
+
+    LogCollector& LogCollector::operator=(const LogCollector& other)
+    {
+        if (this != &other)
+        {
+            StopAsyncDispatch();
+            _onValidationEvent = other._onValidationEvent;
+            _hasSinks = other._hasSinks;
+
+            std::scoped_lock lock(_consumerMutex, other._consumerMutex);
+            other.CollectPending();
+            Reset();
+            CopySettingsAndCounters(other);
+            _logs = other._logs;
+            _groups = other._groups;
+            _groupIndices = other._groupIndices;
+            RebuildIndices();
+        }
+        return *this;
+    }
+
+    LogCollector& LogCollector::operator=(LogCollector&& other) noexcept
+    {
+        if (this != &other)
+        {
+            StopAsyncDispatch();
+            // the moved delegate mustn't be used by the dispatching thread of the other collector
+            other.StopAsyncDispatch();
+            _onValidationEvent = std::move(other._onValidationEvent);
+            _hasSinks = std::exchange(other._hasSinks, false);
+
+            std::scoped_lock lock(_consumerMutex, other._consumerMutex);
+            other.CollectPending();
+            Reset();
+            CopySettingsAndCounters(other);
+            _logs = std::move(other._logs);
+            _groups = std::move(other._groups);
+            _groupIndices = std::move(other._groupIndices);
+            RebuildIndices();
+            other.Reset();
+        }
+        return *this;
+    }
+
+    void LogCollector::AddLog(LogLine logLine)
+    {
+        if (!IsEnabled(logLine.type))
+        {
+            return;
+        }
+
+        if (!Verify(logLine.type != LogType::None, "Was passed LogType::None but expected NOT LogType::None") ||
+            !Verify(logLine.code != EventCode::Message || !logLine.message.IsEmpty(), "Was passed an empty message to the log"))
+        {
+            return;
+        }
+
+        if (logLine.file.IsEmpty())
+        {
+            logLine.file = currentFile;
+        }
+        logLine.sequence = _sequence.fetch_add(1, std::memory_order_relaxed);
+        _counts[ToIndex(logLine.type)].fetch_add(1, std::memory_order_release);
+
+        // the aggregated records reach the sinks only as summaries
+        const bool isAggregating = IsAggregating();
+        const bool isDispatched = !_hasSinks || isAggregating || !IsAsyncDispatch();
+        if (_hasSinks && !isAggregating && isDispatched)
+        {
+            _onValidationEvent.Trigger(logLine.Render(), logLine.type);
+        }
+
+        // the node belongs to the consumers right after the push
+        auto* node = new PendingNode{ std::move(logLine), nullptr, isDispatched };
+        node->next = _pending.load(std::memory_order_relaxed);
+        while (!_pending.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed))
+        {
+        }
+
+        if (isDispatched)
+        {
+            _dispatched.fetch_add(1, std::memory_order_release);
+            _dispatched.notify_all();
+        }
+        else
+        {
+            _wakeups.fetch_add(1, std::memory_order_release);
+            _wakeups.notify_one();
+        }
+
+        // merging keeps the memory bounded only if it's done while producing, a busy consumer is not waited for
+        if (isAggregating && (_pendingCount.fetch_add(1, std::memory_order_relaxed) + 1) % aggregationCollectPeriod == 0)
+        {
+            if (std::unique_lock lock(_consumerMutex, std::try_to_lock); lock.owns_lock())
+            {
+                CollectPending();
+            }
+        }
+    }
+
+    void LogCollector::Subscribe(Sink sink)
+    {
+        _onValidationEvent.Subscribe(std::move(sink));
+        _hasSinks = true;
+    }
+
+    const LogCollector::Container& LogCollector::GetLogs() const
+    {
+        std::scoped_lock lock(_consumerMutex);
+        CollectPending();
+        return _logs;
+    }
+
+    LogCollector::FilteredView LogCollector::GetFilteredLogs(LogType logType) const
+    {
+        std::scoped_lock lock(_consumerMutex);
+        CollectPending();
+        return FilteredView(std::ranges::ref_view(std::as_const(_indices[ToIndex(logType)])), LogLineAt{ &_logs });
+    }
+
+    void LogCollector::ClearLogs()
+    {
+        std::scoped_lock lock(_consumerMutex);
+        CollectPending();
+        _logs.clear();
+        _groups.clear();
+        _groupIndices.clear();
+        RebuildIndices();
+        for (auto&& count : _counts)
+        {
+            count.store(0, std::memory_order_release);
+        }
+    }
+
+    void LogCollector::SortLogs()
+    {
+        std::scoped_lock lock(_consumerMutex);
+        CollectPending();
+        std::ranges::sort(_logs, {},
+                          [](const LogLine& logLine)
+                          {
+                              return std::tuple(logLine.file.ToStringView(), logLine.line, logLine.sequence);
+                          });
+        RebuildIndices();
+    }
+
+    const std::vector<LogCollector::LogGroup>& LogCollector::GetGroups() const
     {
-        if (Verify(logLine.type != LogType::None, "Was passed LogType::None but expected NOT LogType::None") &&
-            Verify(!logLine.message.IsEmpty(), "Was passed an empty message to the log"))
+        std::scoped_lock lock(_consumerMutex);
+        CollectPending();
+        return _groups;
+    }
+
+    void LogCollector::EmitSummary()
+    {
+        if (!_hasSinks)
+        {
+            return;
+        }
+
+        for (auto&& group : GetGroups())
+        {
+            _onValidationEvent.Trigger(group.Render(), group.first.type);
+        }
+    }
+
+    void LogCollector::StartAsyncDispatch()
+    {
+        if (_dispatchThread.joinable())
+        {
+            return;
+        }
+
+        _isStopping.store(false, std::memory_order_release);
+        _isAsyncDispatch.store(true, std::memory_order_release);
+        _dispatchThread = std::thread([this]() { DispatchLoop(); });
+    }
+
+    void LogCollector::StopAsyncDispatch()
+    {
+        if (!_dispatchThread.joinable())
+        {
+            return;
+        }
+
+        _isAsyncDispatch.store(false, std::memory_order_release);
+        _isStopping.store(true, std::memory_order_release);
+        _wakeups.fetch_add(1, std::memory_order_release);
+        _wakeups.notify_one();
+        _dispatchThread.join();
+
+        // records of the producers which still saw the asynchronous mode
+        DispatchCollected();
+    }
+
+    void LogCollector::Flush()
+    {
+        if (!IsAsyncDispatch())
+        {
+            std::scoped_lock lock(_consumerMutex);
+            CollectPending();
+            return;
+        }
+
+        // must not be called by a sink: it would wait for itself
+        const auto target = _sequence.load(std::memory_order_acquire);
+        for (auto dispatched = _dispatched.load(std::memory_order_acquire); dispatched < target;
+             dispatched = _dispatched.load(std::memory_order_acquire))
+        {
+            _dispatched.wait(dispatched, std::memory_order_acquire);
+        }
+    }
+
+    Size LogCollector::GetMemoryUsage() const
+    {
+        std::scoped_lock lock(_consumerMutex);
+        CollectPending();
+
+        Size bytes = MemoryUsageInfo::GetHeapSize(_logs) + MemoryUsageInfo::GetHeapSize(_undispatched);
+        for (auto&& indices : _indices)
+        {
+            bytes += MemoryUsageInfo::GetHeapSize(indices);
+        }
+        for (auto&& logLine : _logs)
+        {
+            bytes += MemoryUsageInfo::GetHeapSize(logLine.message);
+        }
+        bytes += MemoryUsageInfo::GetHeapSize(_groups);
+        for (auto&& group : _groups)
+        {
+            bytes += MemoryUsageInfo::GetHeapSize(group.pattern) + MemoryUsageInfo::GetHeapSize(group.first.message) +
+                     MemoryUsageInfo::GetHeapSize(group.samples);
+        }
+        for (auto&& [key, index] : _groupIndices)
+        {
+            // a rough estimation of a node of the map
+            bytes += sizeof(key) + sizeof(index) + 2 * sizeof(void*) + key.capacity();
+        }
+        return bytes;
+    }
+
+    void LogCollector::CollectPending() const
+    {
+        // the list is built by pushing to the head, so it goes from the newest record to the oldest one
+        PendingNode* reversed = _pending.exchange(nullptr, std::memory_order_acquire);
+        PendingNode* node = nullptr;
+        while (reversed)
+        {
+            node = std::exchange(reversed, std::exchange(reversed->next, node));
+        }
+
+        while (node)
+        {
+            if (IsAggregating())
+            {
+                Aggregate(std::move(node->logLine));
+                delete std::exchange(node, node->next);
+                continue;
+            }
+
+            if (!node->isDispatched)
+            {
+                _undispatched.push_back(node->logLine);
+            }
+            _indices[ToIndex(node->logLine.type)].push_back(static_cast<Index>(_logs.size()));
+            _logs.push_back(std::move(node->logLine));
+            delete std::exchange(node, node->next);
+        }
+    }
+
+    void LogCollector::Aggregate(LogLine&& logLine) const
+    {
+        String pattern = logLine.code == EventCode::Message ? MakePattern(logLine.message.ToStringView()) : String();
+
+        std::string key;
+        key.reserve(pattern.Size() + 2);
+        key += static_cast<char>(logLine.code);
+        key += static_cast<char>(logLine.type);
+        key.append(pattern.c_str(), pattern.Size());
+
+        const auto [it, isInserted] = _groupIndices.try_emplace(std::move(key), _groups.size());
+        if (isInserted)
+        {
+            _indices[ToIndex(logLine.type)].push_back(static_cast<Index>(_logs.size()));
+            _logs.push_back(logLine);
+            _groups.push_back({ std::move(pattern), logLine, 0, {} });
+        }
+
+        auto& group = _groups[it->second];
+        ++group.count;
+        if (group.samples.size() < _sampleLimit.load(std::memory_order_relaxed))
+        {
+            group.samples.push_back({ logLine.file, logLine.line });
+        }
+    }
+
+    void LogCollector::CopySettingsAndCounters(const LogCollector& other)
+    {
+        _severityThreshold = other._severityThreshold.load();
+        _sampleLimit = other._sampleLimit.load();
+        _sequence = other._sequence.load();
+        _dispatched = _sequence.load();
+        for (Size i = 0; i < logTypesCount; ++i)
+        {
+            _counts[i] = other._counts[i].load();
+        }
+    }
+
+    void LogCollector::DispatchLoop()
+    {
+        while (true)
+        {
+            // read before collecting, so a record pushed after the collecting wakes up the wait
+            const auto wakeups = _wakeups.load(std::memory_order_acquire);
+            DispatchCollected();
+            if (_isStopping.load(std::memory_order_acquire))
+            {
+                return;
+            }
+            _wakeups.wait(wakeups, std::memory_order_acquire);
+        }
+    }
+
+    void LogCollector::DispatchCollected()
+    {
+        Container batch;
+        {
+            std::scoped_lock lock(_consumerMutex);
+            CollectPending();
+            batch.swap(_undispatched);
+        }
+
+        if (batch.empty())
+        {
+            return;
+        }
+
+        for (auto&& logLine : batch)
+        {
+            _onValidationEvent.Trigger(logLine.Render(), logLine.type);
+        }
+        _dispatched.fetch_add(batch.size(), std::memory_order_release);
+        _dispatched.notify_all();
+    }
+
+    void LogCollector::Reset() noexcept
+    {
+        for (auto* node = _pending.exchange(nullptr, std::memory_order_acquire); node;)
+        {
+            delete std::exchange(node, node->next);
+        }
+        _logs.clear();
+        _undispatched.clear();
+        _groups.clear();
+        _groupIndices.clear();
+        RebuildIndices();
+        for (auto&& count : _counts)
+        {
+            count.store(0, std::memory_order_release);
+        }
+    }
+
+    void LogCollector::RebuildIndices()
+    {
+        for (auto&& indices : _indices)
+        {
+            indices.clear();
+        }
+        for (Index i = 0; i < static_cast<Index>(_logs.size()); ++i)
         {
-            _logs.emplace_back(logLine);
-            onValidationEvent.Trigger(logLine.message, logLine.type);
+            _indices[ToIndex(_logs[i].type)].push_back(i);
         }
     }
 
-} // namespace Ast
+} // namespace Ast
\ No newline at end of file
@@ -22,11 +22,40 @@
 
 #include "CommonTypes.h"
 #include "Core/Delegate.h"
+#include "Symbol.h"
 #include "Utils/CopyableAndMoveableBehaviour.h"
 
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <ranges>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+
 namespace Ast
 {
 
+    /**
+     * @brief Collects the logs of parsing and validation
+     * @details AddLog is lock-free and may be called from any number of threads: a record is pushed to an atomic list and
+     * moved to the storage by the first reader. The reading methods (GetLogs, HasAny, ...) must not race with the
+     * producers, they are meant to be called when the parsing is done. The sinks are called right in AddLog by default,
+     * or on a background thread in batches after StartAsyncDispatch, so they don't do any I/O on the parsing threads.
+     *
+     * Frequent records are structured: an event code with symbol arguments, formatted by LogLine::Render only when a sink
+     * or a reader needs the text. Records less severe than the threshold are dropped before any work.
+     *
+     * Every type has a counter updated by AddLog and a list of record indices updated on collecting, so HasAny and
+     * GetCount don't touch the records and GetFilteredLogs is a view over the indices of the type.
+     *
+     * In the aggregation mode records with the same event code and message template (numbers and quoted names aside) are
+     * merged into one LogGroup with a count and a bounded sample of locations; only the first record of a group is stored
+     * and the sinks get one summary line per group from EmitSummary.
+     */
     class LogCollector final : public Utils::CopyableAndMoveable
     {
     public:
@@ -39,50 +68,242 @@ namespace Ast
             Success
         };
 
+        /// @brief template of a structured record
+        enum class EventCode : std::uint16_t
+        {
+            Message,     // a plain record with a ready message
+            LexerParsed, // arguments: the lexer type and name
+            ScopesBound  // the lexers of the record's file were bound
+        };
+
         struct LogLine final
         {
+            inline static constexpr Size maxArguments = 2;
+
             String message;
             LogType type = LogType::None;
+            /// @brief the file the record belongs to, taken from the FileScope of the thread if it's empty
+            Symbol file;
+            std::size_t line = 0;
+            /// @brief the order of adding, assigned by the collector
+            std::uint64_t sequence = 0;
+            EventCode code = EventCode::Message;
+            std::array<Symbol, maxArguments> arguments{};
+
+            LogLine() = default;
+            /// @brief a plain record, so the calls like AddLog({ message, type }) don't have to list the structured fields
+            LogLine(String message, LogType type = LogType::None, Symbol file = {}, std::size_t line = 0)
+                : message{ std::move(message) },
+                  type{ type },
+                  file{ file },
+                  line{ line }
+            {
+            }
+
+            [[nodiscard]] static LogLine MakeEvent(EventCode code, LogType type, std::array<Symbol, maxArguments> arguments = {},
+                                                   std::size_t line = 0)
+            {
+                LogLine logLine({}, type, {}, line);
+                logLine.code = code;
+                logLine.arguments = arguments;
+                return logLine;
+            }
+
+            /// @brief the message of the record, formatted from the template for the structured ones
+            [[nodiscard]] String Render() const;
         };
 
         using Container = std::vector<LogLine>;
+        using Sink = std::function<void(const String&, LogType)>;
+        using Index = std::uint32_t;
+
+        inline static constexpr Size logTypesCount = static_cast<Size>(LogType::Success) + 1;
+
+        /// @brief maps an index of the record to the record
+        struct LogLineAt final
+        {
+            const Container* logs = nullptr;
+
+            [[nodiscard]] const LogLine& operator()(Index index) const { return (*logs)[index]; }
+        };
+
+        /// @brief records of one type in the order of storing, valid until the next change of the collector
+        using FilteredView = std::ranges::transform_view<std::ranges::ref_view<const std::vector<Index>>, LogLineAt>;
+
+        struct Location final
+        {
+            Symbol file;
+            std::size_t line = 0;
+        };
+
+        /// @brief records merged in the aggregation mode
+        struct LogGroup final
+        {
+            /// @brief the message with numbers and quoted names replaced by {}
+            String pattern;
+            LogLine first;
+            Size count = 0;
+            std::vector<Location> samples;
+
+            /// @brief the first message with the count and the sampled locations
+            [[nodiscard]] String Render() const;
+        };
+
+        /// @brief stamps the records added by the current thread with the file while the scope is alive
+        class FileScope final
+        {
+        public:
+            explicit FileScope(Symbol file);
+            ~FileScope();
+
+            FileScope(const FileScope&) = delete;
+            FileScope& operator=(const FileScope&) = delete;
+
+        private:
+            Symbol _previous;
+        };
 
     public:
         LogCollector() = default;
-        ~LogCollector() override = default;
+        LogCollector(const LogCollector& other);
+        LogCollector(LogCollector&& other) noexcept;
+        ~LogCollector() override;
+
+        LogCollector& operator=(const LogCollector& other);
+        LogCollector& operator=(LogCollector&& other) noexcept;
+
+        void AddLog(LogLine logLine);
 
-        void AddLog(const LogLine& logLine);
-        [[nodiscard]] const Container& GetLogs() const noexcept { return _logs; }
-        [[nodiscard]] bool IsEmpty() const { return _logs.empty(); }
+        /// @brief the sink gets the rendered message of every record, subscribe all the sinks before adding logs
+        void Subscribe(Sink sink);
 
-        void ClearLogs() { _logs.clear(); }
+        /// @brief records less severe than the threshold are dropped by AddLog, Success is the least severe type
+        void SetSeverityThreshold(LogType logType) noexcept { _severityThreshold.store(GetSeverity(logType), std::memory_order_relaxed); }
+
+        [[nodiscard]] bool IsEnabled(LogType logType) const noexcept
+        {
+            return GetSeverity(logType) >= _severityThreshold.load(std::memory_order_relaxed);
+        }
+
+        [[nodiscard]] const Container& GetLogs() const;
+        [[nodiscard]] bool IsEmpty() const { return GetLogs().empty(); }
+
+        void ClearLogs();
+
+        /// @brief orders the stored logs by file and line, the records of the same line keep the order of adding
+        void SortLogs();
+
+        /**
+         * @brief Turns on merging of similar records, 0 turns it off
+         * @details Set it before adding logs. At most sampleLimit locations are kept per group.
+         */
+        void SetAggregation(Size sampleLimit) noexcept { _sampleLimit.store(sampleLimit, std::memory_order_release); }
+
+        [[nodiscard]] bool IsAggregating() const noexcept { return _sampleLimit.load(std::memory_order_acquire) != 0; }
+
+        /// @brief groups in the order of the first records, empty if the aggregation is off
+        [[nodiscard]] const std::vector<LogGroup>& GetGroups() const;
+
+        /// @brief passes the summary of every group to the sinks
+        void EmitSummary();
+
+        /**
+         * @brief Moves calling of the sinks to a background thread
+         * @details Subscribe all the sinks before the start: they aren't guarded against the dispatching thread.
+         */
+        void StartAsyncDispatch();
+
+        /// @brief dispatches all the records added before the call and stops the background thread
+        void StopAsyncDispatch();
+
+        /// @brief waits until the records added before the call are passed to the sinks
+        void Flush();
+
+        [[nodiscard]] bool IsAsyncDispatch() const noexcept { return _isAsyncDispatch.load(std::memory_order_acquire); }
+
+        /// @brief bytes held by the stored log lines
+        [[nodiscard]] Size GetMemoryUsage() const;
+
+        /// @brief count of the added records of the type, doesn't wait for collecting
+        [[nodiscard]] Size GetCount(LogType logType) const noexcept { return _counts[ToIndex(logType)].load(std::memory_order_acquire); }
+
+        [[nodiscard]] FilteredView GetFilteredLogs(LogType logType) const;
 
         template<LogType logType>
-        [[nodiscard]] bool HasAny() const
+        [[nodiscard]] bool HasAny() const noexcept
         {
-            return std::find_if(_logs.cbegin(), _logs.cend(),
-                                [](const LogLine& logLine)
-                                {
-                                    return logLine.type == logType;
-                                }) != _logs.cend();
+            return GetCount(logType) != 0;
         }
 
         template<LogType logType>
-        [[nodiscard]] Container GetFilteredLogs() const
+        [[nodiscard]] FilteredView GetFilteredLogs() const
         {
-            Container temp;
-            std::copy_if(_logs.cbegin(), _logs.cend(),
-                         [&temp](const LogLine& logLine)
-                         {
-                             return logLine.type == logType;
-                         });
-            return temp;
+            return GetFilteredLogs(logType);
         }
 
-        Core::Delegate<void(const String&, LogType)> onValidationEvent;
+    private:
+        struct PendingNode final
+        {
+            LogLine logLine;
+            PendingNode* next = nullptr;
+            /// @brief was passed to the sinks by AddLog
+            bool isDispatched = true;
+        };
+
+        /// @brief moves the pending records to the storage, must be called under _consumerMutex
+        void CollectPending() const;
+        void DispatchLoop();
+        void DispatchCollected();
+        void Reset() noexcept;
+        /// @brief merges the record into its group, must be called under _consumerMutex
+        void Aggregate(LogLine&& logLine) const;
+        void CopySettingsAndCounters(const LogCollector& other);
+        /// @brief rebuilds the indices from the stored records
+        void RebuildIndices();
+
+        [[nodiscard]] static constexpr Size ToIndex(LogType logType) noexcept { return static_cast<Size>(logType); }
+
+        [[nodiscard]] static constexpr int GetSeverity(LogType logType) noexcept
+        {
+            switch (logType)
+            {
+            case LogType::Success:
+                return 1;
+            case LogType::Info:
+                return 2;
+            case LogType::Warning:
+                return 3;
+            case LogType::Error:
+                return 4;
+            default:
+                return 0;
+            }
+        }
 
     private:
-        Container _logs;
+        mutable std::atomic<PendingNode*> _pending = nullptr;
+        std::atomic<std::uint64_t> _sequence = 0;
+        std::atomic<std::uint64_t> _wakeups = 0;
+        std::atomic<std::uint64_t> _dispatched = 0;
+        std::atomic<bool> _isAsyncDispatch = false;
+        std::atomic<bool> _isStopping = false;
+        std::atomic<int> _severityThreshold = GetSeverity(LogType::Success);
+        std::atomic<Size> _sampleLimit = 0;
+        std::atomic<Size> _pendingCount = 0;
+
+        Core::Delegate<void(const String&, LogType)> _onValidationEvent;
+        bool _hasSinks = false;
+
+        mutable std::mutex _consumerMutex;
+        mutable Container _logs;
+        mutable std::array<std::vector<Index>, logTypesCount> _indices;
+        std::array<std::atomic<Size>, logTypesCount> _counts{};
+        mutable std::vector<LogGroup> _groups;
+        /// @brief the event code, the type and the pattern of a group to its index
+        mutable std::unordered_map<std::string, Size> _groupIndices;
+        /// @brief the collected records which wait for the dispatching thread
+        mutable Container _undispatched;
+        std::thread _dispatchThread;
     };
 
 } // namespace Ast
@@ -0,0 +1,83 @@
+// Copyright (c) 2024 Valerii Koniushenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "CommonTypes.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace Ast
+{
+
+    /**
+     * @brief Approximate amount of bytes held by a parsed tree, split by the kind of the owner.
+     * @details Heap payloads are estimated as size/capacity multiplied by the element size, so the report is stable between
+     * runs and comparable across trees, but it doesn't include allocator overhead.
+     */
+    struct MemoryUsageInfo final
+    {
+        Size contentStream = 0; // the source buffer of the ContentStream
+        Size lexers = 0;        // lexer objects themselves
+        Size strings = 0;       // Strings owned by lexers, names and types are interned and shared, see Symbol
+        Size details = 0;       // fields, parents, template units, constants, name lists and markers
+        Size childPointers = 0; // vectors with child lexers
+        Size logs = 0;          // log entries of the LogCollector
+        Size nodeTable = 0;     // flat arrays of the NodeTable
+
+        /**
+         * @brief Heap payload of the string: its size with the terminator, the spare capacity isn't counted
+         * @details A short string stored inside of the object itself (the small string optimization) has no heap payload,
+         * so 0 is returned for it.
+         */
+        [[nodiscard]] static Size GetHeapSize(const String& string) noexcept
+        {
+            const auto* data = reinterpret_cast<const std::byte*>(string.CStr());
+            const auto* object = reinterpret_cast<const std::byte*>(&string);
+            if (data >= object && data < object + sizeof(String))
+            {
+                return 0;
+            }
+            return (string.Size() + 1) * sizeof(String::CharT);
+        }
+
+        template<class T>
+        [[nodiscard]] static Size GetHeapSize(const std::vector<T>& vector) noexcept
+        {
+            return vector.capacity() * sizeof(T);
+        }
+
+        [[nodiscard]] Size Total() const noexcept { return contentStream + lexers + strings + details + childPointers + logs + nodeTable; }
+
+        MemoryUsageInfo& operator+=(const MemoryUsageInfo& other) noexcept
+        {
+            contentStream += other.contentStream;
+            lexers += other.lexers;
+            strings += other.strings;
+            details += other.details;
+            childPointers += other.childPointers;
+            logs += other.logs;
+            nodeTable += other.nodeTable;
+            return *this;
+        }
+    };
+
+} // namespace Ast
\ No newline at end of file
@@ -43,7 +43,8 @@ namespace Ast
             {
                 return;
             }
-            _object->_lexerName = name;
+            _object->_lexerName = Symbol(name);
+            _object->MarkTreeChanged();
         }
     };
 
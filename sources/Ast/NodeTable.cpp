@@ -0,0 +1,152 @@
+// Copyright (c) 2024 Valerii Koniushenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "NodeTable.h"
+
+#include "MemoryUsage.h"
+
+#include <mutex>
+
+namespace Ast
+{
+
+    void NodeTable::Build(const BaseLexer::Ptr& root)
+    {
+        Clear();
+
+        if (!root)
+        {
+            return;
+        }
+
+        struct PendingNode
+        {
+            BaseLexer::Ptr lexer;
+            NodeId parent = invalidNode;
+            int nesting = 0;
+        };
+
+        std::vector<NodeId> lastChildren;
+        std::vector<PendingNode> stack{ { root, invalidNode, 0 } };
+        while (!stack.empty())
+        {
+            auto pending = std::move(stack.back());
+            stack.pop_back();
+
+            const auto node = AddNode(pending.lexer, pending.parent, pending.nesting);
+            lastChildren.push_back(invalidNode);
+
+            if (pending.parent != invalidNode)
+            {
+                if (lastChildren[pending.parent] == invalidNode)
+                {
+                    _firstChildren[pending.parent] = node;
+                }
+                else
+                {
+                    _nextSiblings[lastChildren[pending.parent]] = node;
+                }
+                lastChildren[pending.parent] = node;
+            }
+
+            // reversed, so children are popped and stored in their natural order
+            const auto& children = pending.lexer->GetChildLexers();
+            for (auto it = children.rbegin(); it != children.rend(); ++it)
+            {
+                if (*it)
+                {
+                    stack.push_back({ *it, node, pending.nesting + 1 });
+                }
+            }
+        }
+    }
+
+    void NodeTable::Clear()
+    {
+        _parents.clear();
+        _firstChildren.clear();
+        _nextSiblings.clear();
+        _typeTags.clear();
+        _nestings.clear();
+        _openOffsets.clear();
+        _closeOffsets.clear();
+        _openLines.clear();
+        _closeLines.clear();
+        _names.clear();
+        _lexers.clear();
+    }
+
+    Size NodeTable::GetMemoryUsage() const noexcept
+    {
+        return MemoryUsageInfo::GetHeapSize(_parents) + MemoryUsageInfo::GetHeapSize(_firstChildren) +
+               MemoryUsageInfo::GetHeapSize(_nextSiblings) + MemoryUsageInfo::GetHeapSize(_typeTags) + MemoryUsageInfo::GetHeapSize(_nestings) +
+               MemoryUsageInfo::GetHeapSize(_openOffsets) +
+               MemoryUsageInfo::GetHeapSize(_closeOffsets) + MemoryUsageInfo::GetHeapSize(_openLines) +
+               MemoryUsageInfo::GetHeapSize(_closeLines) + MemoryUsageInfo::GetHeapSize(_names) + MemoryUsageInfo::GetHeapSize(_lexers);
+    }
+
+    NodeTable::TypeTag NodeTable::GetTypeTag(const String& typeName)
+    {
+        static std::mutex mutex;
+        static std::vector<String> typeNames;
+
+        std::lock_guard lock(mutex);
+
+        const auto it = std::find(typeNames.cbegin(), typeNames.cend(), typeName);
+        if (it != typeNames.cend())
+        {
+            return static_cast<TypeTag>(it - typeNames.cbegin());
+        }
+
+        typeNames.push_back(typeName);
+        return static_cast<TypeTag>(typeNames.size() - 1);
+    }
+
+    NodeTable::NodeId NodeTable::AddNode(const BaseLexer::Ptr& lexer, NodeId parent, int nesting)
+    {
+        const auto node = static_cast<NodeId>(_lexers.size());
+
+        const auto* data = lexer->GetReader() ? lexer->GetReader()->Data().c_str() : nullptr;
+        const auto toOffset = [data](const std::optional<BaseLexer::LineToken>& scope)
+        {
+            return data && scope && scope->IsValid() ? static_cast<Offset>(scope->string - data) : invalidOffset;
+        };
+        const auto toLine = [](const std::optional<BaseLexer::LineToken>& scope)
+        {
+            return scope ? static_cast<std::uint32_t>(scope->line) : 0u;
+        };
+
+        _names.push_back(lexer->GetLexerNameSymbol());
+
+        _parents.push_back(parent);
+        _firstChildren.push_back(invalidNode);
+        _nextSiblings.push_back(invalidNode);
+        _typeTags.push_back(GetTypeTag(lexer->GetLexerType()));
+        _nestings.push_back(static_cast<std::uint16_t>(nesting));
+        _openOffsets.push_back(toOffset(lexer->GetOpenScope()));
+        _closeOffsets.push_back(toOffset(lexer->GetCloseScope()));
+        _openLines.push_back(toLine(lexer->GetOpenScope()));
+        _closeLines.push_back(toLine(lexer->GetCloseScope()));
+        _lexers.push_back(lexer);
+
+        return node;
+    }
+
+} // namespace Ast
@@ -0,0 +1,95 @@
+// Copyright (c) 2024 Valerii Koniushenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "Lexers/BaseLexer.h"
+
+#include <cstdint>
+#include <limits>
+#include <string_view>
+#include <vector>
+
+namespace Ast
+{
+
+    /**
+     * @brief Flat structure-of-arrays view of a lexers tree
+     * @details Every property of a node lives in its own contiguous array and nodes are stored in pre-order, so a full walk
+     * over the tree is a linear scan which touches only the arrays it needs. Rich lexer objects stay reachable by the node id.
+     * The table is a snapshot: it has to be rebuilt after the lexers tree was changed.
+     */
+    class NodeTable final
+    {
+    public:
+        using NodeId = std::uint32_t;
+        using TypeTag = std::uint16_t;
+        using Offset = std::uint32_t;
+
+        inline static constexpr NodeId invalidNode = std::numeric_limits<NodeId>::max();
+        inline static constexpr Offset invalidOffset = std::numeric_limits<Offset>::max();
+
+    public:
+        void Build(const BaseLexer::Ptr& root);
+        void Clear();
+
+        [[nodiscard]] Size GetSize() const noexcept { return _lexers.size(); }
+        [[nodiscard]] bool IsEmpty() const noexcept { return _lexers.empty(); }
+
+        [[nodiscard]] NodeId GetParent(NodeId node) const noexcept { return _parents[node]; }
+        [[nodiscard]] NodeId GetFirstChild(NodeId node) const noexcept { return _firstChildren[node]; }
+        [[nodiscard]] NodeId GetNextSibling(NodeId node) const noexcept { return _nextSiblings[node]; }
+        [[nodiscard]] TypeTag GetTypeTag(NodeId node) const noexcept { return _typeTags[node]; }
+        [[nodiscard]] int GetNesting(NodeId node) const noexcept { return _nestings[node]; }
+        [[nodiscard]] Offset GetOpenOffset(NodeId node) const noexcept { return _openOffsets[node]; }
+        [[nodiscard]] Offset GetCloseOffset(NodeId node) const noexcept { return _closeOffsets[node]; }
+        [[nodiscard]] Size GetOpenLine(NodeId node) const noexcept { return _openLines[node]; }
+        [[nodiscard]] Size GetCloseLine(NodeId node) const noexcept { return _closeLines[node]; }
+
+        [[nodiscard]] Symbol GetNameSymbol(NodeId node) const noexcept { return _names[node]; }
+        [[nodiscard]] Symbol::StringView GetName(NodeId node) const noexcept { return _names[node].ToStringView(); }
+
+        [[nodiscard]] BaseLexer* GetLexer(NodeId node) noexcept { return _lexers[node].get(); }
+        [[nodiscard]] const BaseLexer* GetLexer(NodeId node) const noexcept { return _lexers[node].get(); }
+
+        [[nodiscard]] Size GetMemoryUsage() const noexcept;
+
+        /// @brief process-wide tag of a lexer type, the same type name always gets the same tag
+        [[nodiscard]] static TypeTag GetTypeTag(const String& typeName);
+
+    private:
+        NodeId AddNode(const BaseLexer::Ptr& lexer, NodeId parent, int nesting);
+
+    private:
+        std::vector<NodeId> _parents;
+        std::vector<NodeId> _firstChildren;
+        std::vector<NodeId> _nextSiblings;
+        std::vector<TypeTag> _typeTags;
+        std::vector<std::uint16_t> _nestings;
+        std::vector<Symbol> _names;
+        std::vector<Offset> _openOffsets;
+        std::vector<Offset> _closeOffsets;
+        std::vector<std::uint32_t> _openLines;
+        std::vector<std::uint32_t> _closeLines;
+
+        std::vector<BaseLexer::Ptr> _lexers;
+    };
+
+} // namespace Ast
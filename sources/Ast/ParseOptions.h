@@ -0,0 +1,75 @@
+// Copyright (c) 2024 Valerii Koniushenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "Cancellation.h"
+#include "CommonTypes.h"
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+namespace Ast
+{
+
+    /// @brief Tunes how much work the parser does for a tree, the options are shared by all the lexers of the tree
+    struct ParseOptions final
+    {
+        /**
+         * @brief Defers the detail passes of the lexers (class templates and fields, enum constants...)
+         * @details Lexers are validated and bound into the tree as usual, but the details are analyzed only when they are
+         * requested for the first time (e.g. ClassLexer::GetFields()). The analysis runs once and is thread-safe. Errors found
+         * by a deferred analysis are reported only when it's started explicitly with a LogCollector.
+         */
+        bool lazyDetails = false;
+
+        /**
+         * @brief Parses only the declarations annotated with markers (for C++ the macros of AstCpp/Markers.h)
+         * @details The content is scanned for the markers once and the readers try to match only the declarations right after
+         * them. Unmarked declarations aren't lexed at all, so marked lexers are bound to the nearest marked lexer containing them.
+         */
+        bool markedOnly = false;
+
+        /**
+         * @brief Types of the lexers to parse, e.g: { EnumClassLexer::typeName }. Empty means all the types of the parser
+         * @details Readers of other types don't run at all. Requested lexers are bound to the nearest requested lexer which
+         * contains them, so an enum inside of a skipped class becomes a child of the namespace around that class.
+         */
+        std::vector<String> lexerTypes;
+
+        /**
+         * @brief Time budget of a file, zero means no limit
+         * @details Checked between the tokens of the readers, before the validation of every lexer and while binding the
+         * scopes. Once it's exceeded the parsing stops: the tree keeps the lexers validated so far, an error is logged and
+         * ASTFileTree::IsComplete() returns false.
+         */
+        std::chrono::milliseconds timeBudget{ 0 };
+
+        /// @brief stops the parsing the same way as the time budget when it's cancelled
+        CancellationToken::CPtr cancellationToken;
+
+        [[nodiscard]] bool IsRequested(const String& lexerType) const
+        {
+            return lexerTypes.empty() || std::ranges::find(lexerTypes, lexerType) != lexerTypes.end();
+        }
+    };
+
+} // namespace Ast
\ No newline at end of file
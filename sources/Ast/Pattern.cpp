@@ -0,0 +1,161 @@
+// Copyright (c) 2024 Valerii Koniushenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "Pattern.h"
+
+#include "Core/Assert.h"
+
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+namespace Ast
+{
+
+    struct Pattern::CompiledPattern final
+    {
+        std::basic_string<String::CharT> expression;
+        std::basic_regex<String::CharT> regex;
+        bool isValid = false;
+    };
+
+    class Pattern::Registry final
+    {
+    public:
+        [[nodiscard]] static Registry& Get()
+        {
+            static Registry registry;
+            return registry;
+        }
+
+        [[nodiscard]] const CompiledPattern* Find(StringView expression, Mode mode)
+        {
+            auto key = MakeKey(expression, mode);
+            {
+                std::shared_lock lock(_mutex);
+                if (const auto it = _patterns.find(key); it != _patterns.end())
+                {
+                    return it->second.get();
+                }
+            }
+
+            std::unique_lock lock(_mutex);
+            auto& compiled = _patterns[std::move(key)];
+            if (!compiled)
+            {
+                compiled = Compile(expression, mode);
+            }
+            return compiled.get();
+        }
+
+        [[nodiscard]] Size GetCount() const
+        {
+            std::shared_lock lock(_mutex);
+            return _patterns.size();
+        }
+
+    private:
+        using Key = std::basic_string<String::CharT>;
+
+        [[nodiscard]] static Key MakeKey(StringView expression, Mode mode)
+        {
+            Key key;
+            key.reserve(expression.size() + 1);
+            key += static_cast<String::CharT>('0' + static_cast<int>(mode));
+            key += expression;
+            return key;
+        }
+
+        [[nodiscard]] static std::unique_ptr<const CompiledPattern> Compile(StringView expression, Mode mode)
+        {
+            auto compiled = std::make_unique<CompiledPattern>();
+            compiled->expression = expression;
+
+            auto flags = std::regex::ECMAScript;
+            if (mode == Mode::Multiline)
+            {
+                flags |= std::regex::multiline;
+            }
+
+            try
+            {
+                compiled->regex.assign(compiled->expression, flags);
+                compiled->isValid = true;
+            }
+            catch (const std::regex_error&)
+            {
+                // reported by the constructor of Pattern, TryCompile leaves it to the caller
+            }
+
+            return compiled;
+        }
+
+    private:
+        mutable std::shared_mutex _mutex;
+        // the compiled patterns are never removed, so pointers to them stay valid
+        std::unordered_map<Key, std::unique_ptr<const CompiledPattern>> _patterns;
+    };
+
+    Pattern::Pattern(StringView expression, Mode mode /* = Mode::SingleLine*/)
+        : _compiled{ Registry::Get().Find(expression, mode) }
+    {
+        Verify(_compiled->isValid, "Invalid regular expression");
+    }
+
+    Pattern::Pattern(const String& expression, Mode mode /* = Mode::SingleLine*/)
+        : Pattern(expression.ToStringView(), mode)
+    {
+    }
+
+    bool Pattern::IsValid() const noexcept
+    {
+        return _compiled && _compiled->isValid;
+    }
+
+    StringView Pattern::GetExpression() const noexcept
+    {
+        return _compiled ? StringView(_compiled->expression) : StringView();
+    }
+
+    bool Pattern::Match(StringView text) const
+    {
+        return IsValid() && std::regex_match(text.data(), text.data() + text.size(), _compiled->regex);
+    }
+
+    bool Pattern::Search(const String::CharT* first, const String::CharT* last, MatchResults& match, MatchFlags flags) const
+    {
+        return IsValid() && std::regex_search(first, last, match, _compiled->regex, flags);
+    }
+
+    Pattern Pattern::TryCompile(StringView expression, Mode mode /* = Mode::SingleLine*/)
+    {
+        Pattern pattern;
+        pattern._compiled = Registry::Get().Find(expression, mode);
+        return pattern;
+    }
+
+    Size Pattern::GetPatternsCount()
+    {
+        return Registry::Get().GetCount();
+    }
+
+} // namespace Ast
\ No newline at end of file
@@ -0,0 +1,84 @@
+// Copyright (c) 2024 Valerii Koniushenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "CommonTypes.h"
+
+#include <cstdint>
+#include <regex>
+
+namespace Ast
+{
+
+    /**
+     * @brief Compiled regular expression from the process-wide pattern registry
+     * @details Every expression is compiled once, on the first construction of a Pattern with it; later constructions only
+     * look it up. Compiled patterns are immutable and live until the end of the program, so a Pattern is a cheap handle
+     * which may be copied and used from any thread. Construct patterns at rule construction or in static variables and
+     * keep them, not in the loops which match them.
+     * @code
+     * static const Pattern pattern(R"([A-Z]\w*)");
+     * if (pattern.Match(name.ToStringView())) { ... }
+     * @endcode
+     * An invalid expression passed to the constructor is a programming error. Expressions which come from the user are
+     * compiled by TryCompile() and checked with IsValid().
+     */
+    class Pattern final
+    {
+    public:
+        enum class Mode : std::uint8_t
+        {
+            SingleLine,
+            Multiline // '^' and '$' match at every line
+        };
+
+        using MatchResults = std::match_results<const String::CharT*>;
+        using MatchFlags = std::regex_constants::match_flag_type;
+
+    public:
+        Pattern() = default;
+        explicit Pattern(StringView expression, Mode mode = Mode::SingleLine);
+        explicit Pattern(const String& expression, Mode mode = Mode::SingleLine);
+
+        /// @brief false for a default constructed pattern and for an invalid expression, such a pattern matches nothing
+        [[nodiscard]] bool IsValid() const noexcept;
+        [[nodiscard]] StringView GetExpression() const noexcept;
+
+        /// @brief the whole text matches the pattern
+        [[nodiscard]] bool Match(StringView text) const;
+
+        /// @brief the first match in [first, last)
+        bool Search(const String::CharT* first, const String::CharT* last, MatchResults& match,
+                    MatchFlags flags = std::regex_constants::match_default) const;
+
+        /// @brief the same pattern as the constructor gives, but an invalid expression isn't treated as an error
+        [[nodiscard]] static Pattern TryCompile(StringView expression, Mode mode = Mode::SingleLine);
+
+        [[nodiscard]] static Size GetPatternsCount();
+
+    private:
+        struct CompiledPattern;
+        class Registry;
+
+        const CompiledPattern* _compiled = nullptr;
+    };
+
+} // namespace Ast
\ No newline at end of file
@@ -0,0 +1,92 @@
+// Copyright (c) 2024 Valerii Koniushenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "AnchoredRegexTokenReaderImpl.h"
+
+#include "BaseTokenReader.h"
+#include "ContentStream.h"
+
+#include <algorithm>
+
+namespace Ast
+{
+
+    AnchoredRegexTokenReaderImpl::AnchoredRegexTokenReaderImpl(BaseTokenReader* baseTokenReader, const String& regexExpr, Anchors anchors)
+        : BaseTokenReaderImpl(baseTokenReader),
+          _pattern{ regexExpr },
+          _anchors{ std::move(anchors) }
+    {
+    }
+
+    std::optional<TokenReader> AnchoredRegexTokenReaderImpl::FindNextToken() const
+    {
+        if (!Verify(_baseTokenReader))
+        {
+            return std::nullopt;
+        }
+
+        if (!Verify(!!_baseTokenReader->GetReader()))
+        {
+            return std::nullopt;
+        }
+
+        const auto& data = _baseTokenReader->GetReader()->Data();
+        const auto& lastToken = _baseTokenReader->GetLastToken();
+
+        auto anchor = lastToken.IsValid() ? std::ranges::upper_bound(_anchors, lastToken.beginData) : _anchors.begin();
+        for (; anchor != _anchors.end(); ++anchor)
+        {
+            // a declaration header ends with its scope or with the end of the statement
+            const auto* headerEnd = *anchor;
+            while (*headerEnd != 0 && *headerEnd != '{' && *headerEnd != ';')
+            {
+                ++headerEnd;
+            }
+            if (*headerEnd != 0)
+            {
+                ++headerEnd;
+            }
+
+            Pattern::MatchResults match;
+            if (!_pattern.Search(*anchor, headerEnd, match, std::regex_constants::match_continuous))
+            {
+                continue;
+            }
+
+            TokenReader token;
+            token.beginData = *anchor;
+            while (String::Toolset::IsSpace(*token.beginData))
+            {
+                ++token.beginData;
+            }
+            token.endData = match[0].second;
+
+            token.startLine = String::GetLinesCountInText(data, token.beginData);
+            token.endLine = String::GetLinesCountInText(data, token.endData) - 1; // 1 - to ignore the last '\n'
+
+            _baseTokenReader->SetLastToken(token);
+
+            return std::make_optional(token);
+        }
+
+        return std::nullopt;
+    }
+
+} // namespace Ast
\ No newline at end of file
@@ -0,0 +1,53 @@
+// Copyright (c) 2024 Valerii Koniushenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "../Pattern.h"
+#include "BaseTokenReaderImpl.h"
+
+#include <vector>
+
+namespace Ast
+{
+    class ContentStream;
+
+    /**
+     * @brief Matches the regex only at the given positions of the content instead of searching through all of it
+     * @details Every anchor is a start of a declaration found by a cheaper scan. The regex has to match right at the anchor
+     * within the declaration header (up to the first '{' or ';'), otherwise the anchor is skipped.
+     */
+    class AnchoredRegexTokenReaderImpl : public BaseTokenReaderImpl
+    {
+    public:
+        using Anchors = std::vector<const String::CharT*>;
+
+    public:
+        /// @brief 'anchors' have to be sorted by their positions in the content
+        AnchoredRegexTokenReaderImpl(BaseTokenReader* baseTokenReader, const String& regexExpr, Anchors anchors);
+
+        [[nodiscard]] std::optional<TokenReader> FindNextToken() const override;
+
+    protected:
+        const Pattern _pattern;
+        const Anchors _anchors;
+    };
+
+} // namespace Ast
\ No newline at end of file
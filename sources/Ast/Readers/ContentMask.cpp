@@ -0,0 +1,72 @@
+// Copyright (c) 2024 Valerii Koniushenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "ContentMask.h"
+
+#include <algorithm>
+
+namespace Ast
+{
+
+    void ContentMask::Add(Size begin, Size end)
+    {
+        if (Verify(begin < end, "Impossible to mask an empty range"))
+        {
+            _ranges.push_back({ static_cast<Offset>(begin), static_cast<Offset>(end) });
+        }
+    }
+
+    void ContentMask::Normalize()
+    {
+        std::ranges::sort(_ranges, {}, &Range::begin);
+
+        // merging of the overlapped and adjacent ranges
+        std::vector<Range> merged;
+        merged.reserve(_ranges.size());
+        for (auto&& range : _ranges)
+        {
+            if (!merged.empty() && range.begin <= merged.back().end)
+            {
+                merged.back().end = std::max(merged.back().end, range.end);
+            }
+            else
+            {
+                merged.push_back(range);
+            }
+        }
+
+        merged.shrink_to_fit();
+        _ranges = std::move(merged);
+    }
+
+    const ContentMask::Range* ContentMask::Find(Size offset) const noexcept
+    {
+        // the first range which ends after the offset
+        const auto it = std::ranges::upper_bound(_ranges, offset, {}, [](const Range& range) { return Size{ range.end }; });
+        return it != _ranges.end() && it->begin <= offset ? &*it : nullptr;
+    }
+
+    Size ContentMask::Skip(Size offset) const noexcept
+    {
+        const auto* range = Find(offset);
+        return range ? range->end : offset;
+    }
+
+} // namespace Ast
\ No newline at end of file
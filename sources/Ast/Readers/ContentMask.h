@@ -0,0 +1,69 @@
+// Copyright (c) 2024 Valerii Koniushenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "../CommonTypes.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace Ast
+{
+
+    /**
+     * @brief Ranges of a content which the readers and lexers skip (comments, string literals...) without touching the content
+     * @details Ranges are half-open offsets '[begin, end)' into the content. After Normalize() they are sorted and don't overlap,
+     * so every lookup is a binary search. Offsets and lines of everything else stay exactly those of the original content.
+     */
+    class ContentMask final
+    {
+    public:
+        using Offset = std::uint32_t;
+
+        struct Range final
+        {
+            Offset begin = 0;
+            Offset end = 0;
+        };
+
+    public:
+        /// @brief ranges may be added in any order, call Normalize() when all of them are added
+        void Add(Size begin, Size end);
+        void Normalize();
+        void Clear() noexcept { _ranges.clear(); }
+
+        [[nodiscard]] bool IsEmpty() const noexcept { return _ranges.empty(); }
+        [[nodiscard]] const std::vector<Range>& GetRanges() const noexcept { return _ranges; }
+
+        /// @brief the range which covers the offset or nullptr
+        [[nodiscard]] const Range* Find(Size offset) const noexcept;
+        [[nodiscard]] bool IsMasked(Size offset) const noexcept { return Find(offset) != nullptr; }
+
+        /// @brief the offset itself if it isn't masked, otherwise the end of the range which covers it
+        [[nodiscard]] Size Skip(Size offset) const noexcept;
+
+        [[nodiscard]] Size GetMemoryUsage() const noexcept { return _ranges.capacity() * sizeof(Range); }
+
+    private:
+        std::vector<Range> _ranges;
+    };
+
+} // namespace Ast
\ No newline at end of file
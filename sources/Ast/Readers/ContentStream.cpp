@@ -19,14 +19,54 @@
 // SOFTWARE.
 
 #include "ContentStream.h"
+
+#include "Ast/MemoryUsage.h"
 #include "Utils/Functions.h"
 
+#include <vector>
+
 namespace Ast
 {
 
+    namespace
+    {
+        constexpr Size filterChunkSize = 64 * 1024;
+
+        /// @brief passes the chunk through the filters starting from 'index', the last filter writes into 'output'
+        void Feed(std::span<StreamingContentFilter* const> filters, std::span<StreamingContentFilter::Buffer> stages, Size index,
+                  StringView chunk, StreamingContentFilter::Buffer& output)
+        {
+            if (index == filters.size())
+            {
+                output.append(chunk);
+                return;
+            }
+            if (index + 1 == filters.size())
+            {
+                filters[index]->Process(chunk, output);
+                return;
+            }
+
+            auto& stage = stages[index];
+            stage.clear();
+            filters[index]->Process(chunk, stage);
+            Feed(filters, stages, index + 1, stage, output);
+        }
+    } // namespace
+
+    void StreamingContentFilter::MakeTransform(String& content)
+    {
+        Buffer output;
+        output.reserve(content.Size());
+        Process(StringView(content.c_str(), content.Size()), output);
+        Finish(output);
+        content = String(output.data(), output.size());
+    }
+
     bool ContentStream::Read(const String::CharT* content)
     {
         _content = String(content);
+        _mask.Clear();
         return !_content.IsEmpty();
     }
 
@@ -35,4 +75,48 @@ namespace Ast
         return _content;
     }
 
+    void ContentStream::ApplyStreamingFilters(std::span<StreamingContentFilter* const> filters)
+    {
+        if (filters.empty())
+        {
+            return;
+        }
+
+        StreamingContentFilter::Buffer output;
+        output.reserve(_content.Size());
+        std::vector<StreamingContentFilter::Buffer> stages(filters.size());
+
+        const StringView content(_content.c_str(), _content.Size());
+        for (Size offset = 0; offset < content.size(); offset += filterChunkSize)
+        {
+            Feed(filters, stages, 0, content.substr(offset, filterChunkSize), output);
+        }
+
+        // the rest of a filter state still has to go through the next filters
+        for (Size i = 0; i < filters.size(); ++i)
+        {
+            auto& tail = stages[i];
+            tail.clear();
+            filters[i]->Finish(tail);
+            Feed(filters, stages, i + 1, tail, output);
+        }
+
+        _content = String(output.data(), output.size());
+    }
+
+    bool ContentStream::IsMasked(const String::CharT* position) const noexcept
+    {
+        return !_mask.IsEmpty() && _mask.IsMasked(position - _content.c_str());
+    }
+
+    const String::CharT* ContentStream::SkipMasked(const String::CharT* position) const noexcept
+    {
+        return _mask.IsEmpty() ? position : _content.c_str() + _mask.Skip(position - _content.c_str());
+    }
+
+    Size ContentStream::GetMemoryUsage() const noexcept
+    {
+        return sizeof(ContentStream) + MemoryUsageInfo::GetHeapSize(_content) + _mask.GetMemoryUsage();
+    }
+
 } // namespace Ast
\ No newline at end of file
@@ -21,11 +21,17 @@
 #pragma once
 
 #include "../CommonTypes.h"
+#include "ContentMask.h"
 #include "Utils/CopyableAndMoveableBehaviour.h"
 
 #include <boost/smart_ptr/intrusive_ptr.hpp>
 #include <boost/smart_ptr/intrusive_ref_counter.hpp>
 
+#include <array>
+#include <span>
+#include <string>
+#include <tuple>
+
 namespace Ast
 {
 
@@ -40,6 +46,43 @@ namespace Ast
     template<class T>
     concept IsContentFilter = std::is_base_of_v<ContentFilter, T>;
 
+    /**
+     * @brief Filter which transforms the content chunk by chunk and carries its state between the chunks
+     * @details ContentStream::ApplyFilters fuses streaming filters into one pass: every chunk goes through all of them and
+     * only the last one writes into the output buffer, intermediate buffers are of a chunk size and reused.
+     */
+    struct StreamingContentFilter : public ContentFilter
+    {
+        using Buffer = std::basic_string<String::CharT>;
+
+        /// @brief appends the transformed chunk to 'output', a construction split between chunks is kept in the filter state
+        virtual void Process(StringView chunk, Buffer& output) = 0;
+
+        /// @brief appends what is left in the state after the last chunk
+        virtual void Finish(Buffer& output) = 0;
+
+        /// @brief the filter alone, the whole content is a single chunk
+        void MakeTransform(String& content) override;
+
+    protected:
+        StreamingContentFilter() = default;
+    };
+
+    template<class T>
+    concept IsStreamingContentFilter = std::is_base_of_v<StreamingContentFilter, T>;
+
+    /// @brief non-destructive alternative to ContentFilter: marks the ranges to skip instead of rewriting the content
+    struct ContentMasker : public ::Utils::CopyableAndMoveable
+    {
+        virtual void MakeMask(const String& content, ContentMask& mask) = 0;
+
+    protected:
+        ContentMasker() = default;
+    };
+
+    template<class T>
+    concept IsContentMasker = std::is_base_of_v<ContentMasker, T>;
+
     class ContentStream : public ::Utils::CopyableAndMoveable, public boost::intrusive_ref_counter<ContentStream>
     {
     public:
@@ -50,21 +93,61 @@ namespace Ast
         bool Read(const String::CharT* content);
         [[nodiscard]] const String& Data() const noexcept;
 
+        /// @brief bytes held by the stream including its buffer
+        [[nodiscard]] virtual Size GetMemoryUsage() const noexcept;
+
         [[nodiscard]] static Ptr Create()
         {
             return { new ContentStream() };
         }
 
+        /**
+         * @brief Rewrites the content, the mask is dropped since its offsets are not valid anymore
+         * @details Streaming filters are fused into one pass over the content, other filters make a pass each
+         */
         template<IsContentFilter... Filter>
         void ApplyFilters()
         {
-            (Filter{}.MakeTransform(_content), ...);
+            if constexpr ((IsStreamingContentFilter<Filter> && ...))
+            {
+                std::tuple<Filter...> filters;
+                std::apply(
+                    [this](auto&... filter)
+                    {
+                        const std::array<StreamingContentFilter*, sizeof...(Filter)> pointers{ &filter... };
+                        ApplyStreamingFilters(pointers);
+                    },
+                    filters);
+            }
+            else
+            {
+                (Filter{}.MakeTransform(_content), ...);
+            }
+            _mask.Clear();
         }
 
+        template<IsContentMasker... Masker>
+        void ApplyMasks()
+        {
+            (Masker{}.MakeMask(_content, _mask), ...);
+            _mask.Normalize();
+        }
+
+        [[nodiscard]] const ContentMask& GetMask() const noexcept { return _mask; }
+
+        /// @brief 'position' has to point into Data()
+        [[nodiscard]] bool IsMasked(const String::CharT* position) const noexcept;
+
+        /// @brief 'position' itself if it isn't masked, otherwise the end of the masked range which covers it
+        [[nodiscard]] const String::CharT* SkipMasked(const String::CharT* position) const noexcept;
+
     protected:
         ContentStream() = default;
 
+        void ApplyStreamingFilters(std::span<StreamingContentFilter* const> filters);
+
         String _content;
+        ContentMask _mask;
     };
 
 } // namespace Ast
\ No newline at end of file
@@ -27,6 +27,7 @@ namespace Ast
 
     bool FileReader::ReadFromFile(const std::filesystem::path& path)
     {
+        _mask.Clear();
         if ((_content = Utils::GetTextFileContentAs<String>(path)))
         {
             _content.ShrinkToFit();
@@ -35,4 +36,10 @@ namespace Ast
         return !_content.IsEmpty();
     }
 
+    Size FileReader::GetMemoryUsage() const noexcept
+    {
+        return ContentStream::GetMemoryUsage() + sizeof(FileReader) - sizeof(ContentStream) +
+               _path.native().size() * sizeof(std::filesystem::path::value_type);
+    }
+
 } // namespace Ast
\ No newline at end of file
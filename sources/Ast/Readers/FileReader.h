@@ -39,6 +39,8 @@ namespace Ast
 
         std::filesystem::path GetPathToFile() const noexcept { return _path; }
 
+        [[nodiscard]] Size GetMemoryUsage() const noexcept override;
+
     protected:
         std::filesystem::path _path;
     };
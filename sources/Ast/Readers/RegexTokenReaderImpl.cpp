@@ -58,35 +58,24 @@ namespace Ast
         {
             offset = static_cast<std::size_t>(tempToken.endData - data.c_str());
         }
-        bool wasFoundAtLeastOneToken = false;
 
-        data.IterateRegex(
-            _regexExpr,
-            [&](const String::StdRegexMatchResults& match)
-            {
-                wasFoundAtLeastOneToken = true;
-                auto s = match[0];
-
-                tempToken.beginData = data.c_str() + (match[0].first - data.begin());
-                while (String::Toolset::IsSpace(*tempToken.beginData))
-                {
-                    ++tempToken.beginData;
-                }
-
-                tempToken.endData = data.c_str() + (match[0].second - data.begin());
-
-                tempToken.startLine = String::GetLinesCountInText(data, tempToken.beginData);
-                tempToken.endLine = String::GetLinesCountInText(data, tempToken.endData) - 1; // 1 - to ignore the last '\n'
-
-                return false;
-            },
-            offset);
-
-        if (!wasFoundAtLeastOneToken)
+        Pattern::MatchResults match;
+        if (!_pattern.Search(data.c_str() + offset, data.c_str() + data.Size(), match))
         {
             return std::nullopt;
         }
 
+        tempToken.beginData = match[0].first;
+        while (String::Toolset::IsSpace(*tempToken.beginData))
+        {
+            ++tempToken.beginData;
+        }
+
+        tempToken.endData = match[0].second;
+
+        tempToken.startLine = String::GetLinesCountInText(data, tempToken.beginData);
+        tempToken.endLine = String::GetLinesCountInText(data, tempToken.endData) - 1; // 1 - to ignore the last '\n'
+
         _baseTokenReader->SetLastToken(tempToken);
 
         return std::make_optional(tempToken);
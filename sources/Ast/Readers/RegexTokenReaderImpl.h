@@ -20,6 +20,7 @@
 
 #pragma once
 
+#include "../Pattern.h"
 #include "BaseTokenReaderImpl.h"
 
 namespace Ast
@@ -31,7 +32,7 @@ namespace Ast
     public:
         RegexTokenReaderImpl(BaseTokenReader* baseTokenReader, const String& regexExpr)
             : BaseTokenReaderImpl(baseTokenReader),
-              _regexExpr{ regexExpr }
+              _pattern{ regexExpr, Pattern::Mode::Multiline }
         {
         }
 
@@ -41,7 +42,7 @@ namespace Ast
         std::size_t GetLinesCountInText(const String& source, const String::CharT* end) const;
 
     protected:
-        const String _regexExpr;
+        const Pattern _pattern;
     };
 
 } // namespace Ast
\ No newline at end of file
@@ -26,6 +26,8 @@
 #include <boost/smart_ptr/intrusive_ptr.hpp>
 #include <boost/smart_ptr/intrusive_ref_counter.hpp>
 
+#include <typeinfo>
+
 namespace Ast
 {
     class BaseLexer;
@@ -38,6 +40,9 @@ namespace Ast
         [[nodiscard]] virtual bool IsCorrespondingTheRules(const BaseLexer* lexer, LogCollector& logCollector,
                                                            const char* additionalMessage = nullptr) const = 0;
 
+        /// @brief identifies what the rule checks for RuleCache, the rules with parameters must add them
+        [[nodiscard]] virtual String GetFingerprint() const { return typeid(*this).name(); }
+
     protected:
     };
 
@@ -0,0 +1,246 @@
+// Copyright (c) 2024 Valerii Koniushenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "RuleCache.h"
+
+#include <fstream>
+#include <mutex>
+
+namespace Ast
+{
+
+    namespace
+    {
+        constexpr std::uint32_t fileMagic = 0x43525341; // "ASRC"
+        constexpr std::uint32_t fileVersion = 1;
+
+        template<class T>
+        void Write(std::ostream& stream, T value)
+        {
+            stream.write(reinterpret_cast<const char*>(&value), sizeof(value));
+        }
+
+        template<class T>
+        [[nodiscard]] bool Read(std::istream& stream, T& value)
+        {
+            return !!stream.read(reinterpret_cast<char*>(&value), sizeof(value));
+        }
+    } // namespace
+
+    void RuleCache::Hasher::Add(StringView data) noexcept
+    {
+        for (const auto ch : data)
+        {
+            _hash = (_hash ^ static_cast<unsigned char>(ch)) * 1099511628211ull;
+        }
+        // separates the adjacent strings: "ab" + "c" differs from "a" + "bc"
+        Add(static_cast<std::uint64_t>(data.size()));
+    }
+
+    void RuleCache::Hasher::Add(std::uint64_t value) noexcept
+    {
+        for (int i = 0; i < 8; ++i, value >>= 8)
+        {
+            _hash = (_hash ^ (value & 0xff)) * 1099511628211ull;
+        }
+    }
+
+    std::optional<RuleCache::Key> RuleCache::MakeKey(const BaseLexer& lexer, Key programHash)
+    {
+        const auto& token = lexer.GetTokenReader();
+        if (!token.IsValid())
+        {
+            return std::nullopt;
+        }
+
+        Hasher hasher;
+        hasher.Add(programHash);
+
+        // the rules may look at the parents, the text of the lexer doesn't include them
+        for (const auto* parent = lexer.GetParentLexer().get(); parent; parent = parent->GetParentLexer().get())
+        {
+            hasher.Add(parent->GetLexerType().ToStringView());
+            hasher.Add(parent->GetLexerName().ToStringView());
+        }
+
+        hasher.Add(lexer.GetLexerType().ToStringView());
+        const auto* end = token.endData;
+        if (const auto closeScope = lexer.GetCloseScope(); closeScope && closeScope->string >= end)
+        {
+            end = closeScope->string + 1;
+        }
+        hasher.Add(StringView(token.beginData, static_cast<Size>(end - token.beginData)));
+        if (const auto openScope = lexer.GetOpenScope(); openScope && lexer.GetCloseScope())
+        {
+            // the line count of the scope, the text alone doesn't keep the lines of a filtered content
+            hasher.Add(static_cast<std::uint64_t>(lexer.GetCloseScope()->line - openScope->line));
+        }
+
+        return hasher.Get();
+    }
+
+    std::size_t RuleCache::GetBaseLine(const BaseLexer& lexer) noexcept
+    {
+        const auto openScope = lexer.GetOpenScope();
+        return openScope ? openScope->line : 0;
+    }
+
+    const RuleCache::Entry* RuleCache::Find(Key key)
+    {
+        const auto found = _loaded.find(key);
+        if (found == _loaded.end())
+        {
+            _misses.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        _hits.fetch_add(1, std::memory_order_relaxed);
+        {
+            const std::unique_lock lock(_mutex);
+            _current.try_emplace(key, found->second);
+        }
+        return &found->second;
+    }
+
+    void RuleCache::Store(Key key, Entry entry)
+    {
+        const std::unique_lock lock(_mutex);
+        _current.insert_or_assign(key, std::move(entry));
+    }
+
+    bool RuleCache::Load(const std::filesystem::path& path)
+    {
+        _loaded.clear();
+        _current.clear();
+
+        std::error_code error;
+        const auto fileSize = std::filesystem::file_size(path, error);
+        std::ifstream stream(path, std::ios::binary);
+        if (error || !stream)
+        {
+            return false;
+        }
+
+        // every size read from the file is checked against the bytes left, so a damaged file can't request a huge buffer
+        std::uint64_t bytesLeft = fileSize;
+        const auto readValue = [&stream, &bytesLeft](auto& value)
+        {
+            if (bytesLeft < sizeof(value) || !Read(stream, value))
+            {
+                return false;
+            }
+            bytesLeft -= sizeof(value);
+            return true;
+        };
+        const auto fits = [&bytesLeft](std::uint64_t count, std::uint64_t itemSize) { return count <= bytesLeft / itemSize; };
+
+        constexpr std::uint64_t entryHeaderSize = sizeof(Key) + 2 * sizeof(std::uint64_t) + sizeof(std::uint32_t);
+        constexpr std::uint64_t recordHeaderSize = sizeof(std::uint8_t) + sizeof(std::uint64_t) + sizeof(std::uint32_t);
+
+        const auto readEntries = [&]()
+        {
+            std::uint32_t magic = 0;
+            std::uint32_t version = 0;
+            std::uint64_t entriesCount = 0;
+            if (!readValue(magic) || magic != fileMagic || !readValue(version) || version != fileVersion || !readValue(entriesCount) ||
+                !fits(entriesCount, entryHeaderSize))
+            {
+                return false;
+            }
+
+            for (std::uint64_t i = 0; i < entriesCount; ++i)
+            {
+                Key key = 0;
+                std::uint64_t checks = 0;
+                std::uint64_t violations = 0;
+                std::uint32_t recordsCount = 0;
+                if (!readValue(key) || !readValue(checks) || !readValue(violations) || !readValue(recordsCount) ||
+                    !fits(recordsCount, recordHeaderSize))
+                {
+                    return false;
+                }
+
+                Entry entry{ static_cast<Size>(checks), static_cast<Size>(violations), {} };
+                for (std::uint32_t j = 0; j < recordsCount; ++j)
+                {
+                    std::uint8_t type = 0;
+                    std::uint64_t line = 0;
+                    std::uint32_t messageSize = 0;
+                    if (!readValue(type) || type > static_cast<std::uint8_t>(LogCollector::LogType::Success) || !readValue(line) ||
+                        !readValue(messageSize) || !fits(messageSize, 1))
+                    {
+                        return false;
+                    }
+
+                    std::string message(messageSize, '\0');
+                    if (!stream.read(message.data(), messageSize))
+                    {
+                        return false;
+                    }
+                    bytesLeft -= messageSize;
+                    entry.records.push_back({ String(message), static_cast<LogCollector::LogType>(type), static_cast<std::size_t>(line) });
+                }
+                _loaded.insert_or_assign(key, std::move(entry));
+            }
+
+            return true;
+        };
+
+        if (!readEntries())
+        {
+            _loaded.clear();
+            return false;
+        }
+
+        return true;
+    }
+
+    bool RuleCache::Save(const std::filesystem::path& path) const
+    {
+        std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+        if (!stream)
+        {
+            return false;
+        }
+
+        const std::shared_lock lock(_mutex);
+        Write(stream, fileMagic);
+        Write(stream, fileVersion);
+        Write(stream, static_cast<std::uint64_t>(_current.size()));
+        for (auto&& [key, entry] : _current)
+        {
+            Write(stream, key);
+            Write(stream, static_cast<std::uint64_t>(entry.checks));
+            Write(stream, static_cast<std::uint64_t>(entry.violations));
+            Write(stream, static_cast<std::uint32_t>(entry.records.size()));
+            for (auto&& record : entry.records)
+            {
+                const auto message = record.message.ToStringView();
+                Write(stream, static_cast<std::uint8_t>(record.type));
+                Write(stream, static_cast<std::uint64_t>(record.line));
+                Write(stream, static_cast<std::uint32_t>(message.size()));
+                stream.write(message.data(), static_cast<std::streamsize>(message.size()));
+            }
+        }
+
+        return !!stream;
+    }
+
+} // namespace Ast
\ No newline at end of file
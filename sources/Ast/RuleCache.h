@@ -0,0 +1,111 @@
+// Copyright (c) 2024 Valerii Koniushenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "Lexers/BaseLexer.h"
+#include "LogCollector.h"
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace Ast
+{
+
+    /**
+     * @brief Results of rules per lexer, kept between runs
+     * @details A key is a hash of the text of the lexer with its children, of its path in the tree and of the rule program
+     * (see RuleSet::GetProgramHash), so an entry is found only while both the lexer and its rules are unchanged. An entry
+     * keeps the counters of the checks and the log records of the rules, which are replayed instead of checking again.
+     * Only the entries looked up or stored since Load are saved, so the file never keeps results of removed code.
+     * Lookups and stores are thread-safe, so RuleSet::Apply may share a cache between its threads.
+     * @code
+     * Ast::RuleCache cache;
+     * cache.Load(".ast-rules-cache");
+     * ruleSet.Apply(trees, logCollector, 0, &cache);
+     * cache.Save(".ast-rules-cache");
+     * @endcode
+     */
+    class RuleCache final
+    {
+    public:
+        using Key = std::uint64_t;
+
+        struct Record final
+        {
+            String message;
+            LogCollector::LogType type = LogCollector::LogType::None;
+            std::size_t line = 0; ///< 1 + the offset from the open scope of the lexer, 0 if the record had no line
+        };
+
+        struct Entry final
+        {
+            Size checks = 0;
+            Size violations = 0;
+            std::vector<Record> records;
+        };
+
+        /// @brief FNV-1a, stable between runs and builds unlike std::hash
+        class Hasher final
+        {
+        public:
+            void Add(StringView data) noexcept;
+            void Add(std::uint64_t value) noexcept;
+            [[nodiscard]] Key Get() const noexcept { return _hash; }
+
+        private:
+            Key _hash = 14695981039346656037ull;
+        };
+
+    public:
+        RuleCache() = default;
+        RuleCache(const RuleCache&) = delete;
+        RuleCache& operator=(const RuleCache&) = delete;
+
+        /// @brief replaces the loaded entries, false if the file is absent or damaged (the cache is empty then)
+        bool Load(const std::filesystem::path& path);
+        bool Save(const std::filesystem::path& path) const;
+
+        /// @brief nullopt for a lexer without a token in the content, such lexers aren't cached
+        [[nodiscard]] static std::optional<Key> MakeKey(const BaseLexer& lexer, Key programHash);
+        [[nodiscard]] static std::size_t GetBaseLine(const BaseLexer& lexer) noexcept;
+
+        /// @brief the loaded entry, it's kept for the next Save
+        [[nodiscard]] const Entry* Find(Key key);
+        void Store(Key key, Entry entry);
+
+        [[nodiscard]] Size GetHitsCount() const noexcept { return _hits.load(std::memory_order_relaxed); }
+        [[nodiscard]] Size GetMissesCount() const noexcept { return _misses.load(std::memory_order_relaxed); }
+
+    private:
+        std::unordered_map<Key, Entry> _loaded; ///< isn't changed after Load
+        std::unordered_map<Key, Entry> _current;
+        mutable std::shared_mutex _mutex;
+
+        std::atomic<Size> _hits = 0;
+        std::atomic<Size> _misses = 0;
+    };
+
+} // namespace Ast
\ No newline at end of file
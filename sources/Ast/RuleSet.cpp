@@ -0,0 +1,269 @@
+// Copyright (c) 2024 Valerii Koniushenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "RuleSet.h"
+
+#include "Utils/String.h"
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <optional>
+#include <thread>
+
+namespace Ast
+{
+
+    namespace
+    {
+        struct MarkerKey final
+        {
+            StringView rule;
+            StringView param;
+        };
+
+        /// @brief "CLASS(Serializable)" -> { "CLASS", "Serializable" }, "Serializable" -> { "", "Serializable" }
+        [[nodiscard]] MarkerKey ParseMarker(StringView marker) noexcept
+        {
+            marker = Utils::TrimView(marker);
+            const auto open = marker.find('(');
+            if (open == StringView::npos || !marker.ends_with(')'))
+            {
+                return { {}, marker };
+            }
+
+            return { Utils::TrimView(marker.substr(0, open)), Utils::TrimView(marker.substr(open + 1, marker.size() - open - 2)) };
+        }
+    } // namespace
+
+    void RuleSet::Add(const String& lexerType, Rule::CPtr rule, const String& additionalMessage /* = {}*/, const String& marker /* = {}*/)
+    {
+        if (!Verify(!!rule, "Rule was nullptr") || !Verify(!lexerType.IsEmpty(), "Lexer type was empty"))
+        {
+            return;
+        }
+
+        const auto typeTag = NodeTable::GetTypeTag(lexerType);
+        if (_rules.size() <= typeTag)
+        {
+            _rules.resize(typeTag + 1);
+        }
+
+        ++_rulesCount;
+        auto& typeRules = _rules[typeTag];
+        typeRules.lexerType = lexerType;
+        if (marker.IsEmpty())
+        {
+            typeRules.common.push_back({ std::move(rule), additionalMessage, {} });
+            return;
+        }
+
+        const auto [markerRule, param] = ParseMarker(marker.ToStringView());
+        if (!Verify(!param.empty(), "Marker parameter was empty"))
+        {
+            --_rulesCount;
+            return;
+        }
+        typeRules.marked[std::string(param)].push_back({ std::move(rule), additionalMessage, String(markerRule.data(), markerRule.size()) });
+        ++_markedRulesCount;
+    }
+
+    RuleCache::Key RuleSet::GetProgramHash() const
+    {
+        // the order of the type tags and of the marker buckets isn't stable between runs, so the hashes of the rules are summed
+        RuleCache::Key programHash = _rulesCount;
+        const auto addRules = [&programHash](const String& lexerType, StringView markerParam, const std::vector<Entry>& entries)
+        {
+            for (Size i = 0; i < entries.size(); ++i)
+            {
+                RuleCache::Hasher hasher;
+                hasher.Add(lexerType.ToStringView());
+                hasher.Add(markerParam);
+                hasher.Add(entries[i].markerRule.ToStringView());
+                hasher.Add(static_cast<std::uint64_t>(i));
+                hasher.Add(entries[i].rule->GetFingerprint().ToStringView());
+                hasher.Add(entries[i].additionalMessage.ToStringView());
+                programHash += hasher.Get();
+            }
+        };
+
+        for (auto&& typeRules : _rules)
+        {
+            addRules(typeRules.lexerType, {}, typeRules.common);
+            for (auto&& [param, entries] : typeRules.marked)
+            {
+                addRules(typeRules.lexerType, param, entries);
+            }
+        }
+
+        return programHash;
+    }
+
+    RuleSet::Result RuleSet::Apply(const ASTFileTree& tree, LogCollector& logCollector, RuleCache* cache /* = nullptr*/) const
+    {
+        const LogCollector::FileScope fileScope{ Symbol(tree.GetFileName()) };
+
+        // the records of the checked lexers are captured here to be cached, then passed on
+        std::optional<LogCollector> capturedLogs;
+        const auto programHash = cache ? GetProgramHash() : RuleCache::Key{};
+        Result result;
+        const auto pinnedTable = tree.GetNodeTable();
+        const auto& nodeTable = *pinnedTable;
+        const auto nodesCount = static_cast<NodeTable::NodeId>(nodeTable.GetSize());
+        for (NodeTable::NodeId node = 0; node < nodesCount; ++node)
+        {
+            const auto typeTag = nodeTable.GetTypeTag(node);
+            if (typeTag >= _rules.size())
+            {
+                continue;
+            }
+
+            const auto* lexer = nodeTable.GetLexer(node);
+            const auto& typeRules = _rules[typeTag];
+            const auto key = cache ? RuleCache::MakeKey(*lexer, programHash) : std::nullopt;
+            if (!key)
+            {
+                ApplyToLexer(typeRules, lexer, logCollector, result);
+                continue;
+            }
+
+            const auto baseLine = RuleCache::GetBaseLine(*lexer);
+            if (const auto* entry = cache->Find(*key))
+            {
+                result.checks += entry->checks;
+                result.violations += entry->violations;
+                for (auto&& [message, type, line] : entry->records)
+                {
+                    LogCollector::LogLine logLine{ message, type };
+                    logLine.line = line == 0 ? 0 : baseLine + line - 1;
+                    logCollector.AddLog(std::move(logLine));
+                }
+                continue;
+            }
+
+            if (!capturedLogs)
+            {
+                capturedLogs.emplace();
+            }
+            const auto logsBegin = capturedLogs->GetLogs().size();
+
+            Result lexerResult;
+            ApplyToLexer(typeRules, lexer, *capturedLogs, lexerResult);
+            result += lexerResult;
+
+            RuleCache::Entry entry{ lexerResult.checks, lexerResult.violations, {} };
+            const auto& logs = capturedLogs->GetLogs();
+            for (auto i = logsBegin; i < logs.size(); ++i)
+            {
+                const auto line = logs[i].line >= baseLine && logs[i].line != 0 ? logs[i].line - baseLine + 1 : 0;
+                entry.records.push_back({ logs[i].Render(), logs[i].type, line });
+                logCollector.AddLog(logs[i]);
+            }
+            cache->Store(*key, std::move(entry));
+        }
+
+        return result;
+    }
+
+    void RuleSet::ApplyToLexer(const TypeRules& typeRules, const BaseLexer* lexer, LogCollector& logCollector, Result& result)
+    {
+        const auto check = [&](const Entry& entry)
+        {
+            ++result.checks;
+            const auto* additionalMessage = entry.additionalMessage.IsEmpty() ? nullptr : entry.additionalMessage.c_str();
+            if (!entry.rule->IsCorrespondingTheRules(lexer, logCollector, additionalMessage))
+            {
+                ++result.violations;
+            }
+        };
+
+        std::ranges::for_each(typeRules.common, check);
+        if (typeRules.marked.empty())
+        {
+            return;
+        }
+
+        const auto* mark = lexer->FindMark();
+        if (!mark)
+        {
+            return;
+        }
+
+        for (auto&& param : mark->params)
+        {
+            const auto found = typeRules.marked.find(param.ToStringView());
+            if (found == typeRules.marked.end())
+            {
+                continue;
+            }
+
+            for (auto&& entry : found->second)
+            {
+                if (entry.markerRule.IsEmpty() || entry.markerRule == mark->rule)
+                {
+                    check(entry);
+                }
+            }
+        }
+    }
+
+    RuleSet::Result RuleSet::Apply(std::span<const ASTFileTree::CPtr> trees, LogCollector& logCollector, Size threadsCount /* = 0*/,
+                                   RuleCache* cache /* = nullptr*/) const
+    {
+        if (threadsCount == 0)
+        {
+            threadsCount = std::max<Size>(std::thread::hardware_concurrency(), 1);
+        }
+        threadsCount = std::min(threadsCount, trees.size());
+
+        std::atomic<Size> nextTree = 0;
+        std::vector<Result> results(threadsCount);
+        const auto applyToTrees = [&](Result& result)
+        {
+            for (auto i = nextTree.fetch_add(1, std::memory_order_relaxed); i < trees.size(); i = nextTree.fetch_add(1, std::memory_order_relaxed))
+            {
+                if (Verify(!!trees[i], "Tree was nullptr"))
+                {
+                    result += Apply(*trees[i], logCollector, cache);
+                }
+            }
+        };
+
+        if (threadsCount != 0)
+        {
+            // the calling thread is one of the workers, the others are joined at the end of the scope
+            std::vector<std::jthread> workers;
+            workers.reserve(threadsCount - 1);
+            for (Size i = 1; i < threadsCount; ++i)
+            {
+                workers.emplace_back(applyToTrees, std::ref(results[i]));
+            }
+            applyToTrees(results.front());
+        }
+
+        Result total;
+        for (auto&& result : results)
+        {
+            total += result;
+        }
+        return total;
+    }
+
+} // namespace Ast
\ No newline at end of file
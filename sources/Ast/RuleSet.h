@@ -0,0 +1,123 @@
+// Copyright (c) 2024 Valerii Koniushenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "ASTFileTree.h"
+#include "Rule.h"
+#include "RuleCache.h"
+
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace Ast
+{
+    /**
+     * @brief Rules registered per lexer type and applied to whole trees
+     * @details A tree is walked once over its node table whatever the count of rules is: the rules of a node are found by
+     * the type tag of the node. Several trees are spread over threads, the rules are only read, so they must be
+     * thread-safe in IsCorrespondingTheRules as all the rules of the project are.
+     * A rule added with a marker is checked only for the lexers marked with it: "Serializable" is a parameter of any
+     * mark, "CLASS(Serializable)" is a parameter of the mark CLASS only. Such rules are found by a hash lookup per
+     * parameter of the mark, so the lexers without marks never pay for them.
+     * @code
+     * Ast::RuleSet ruleSet;
+     * ruleSet.Add<Ast::Cpp::ClassLexer>(new Ast::Cpp::NameRule(R"([A-Z]\w*)"));
+     * ruleSet.Add<Ast::Cpp::ClassLexer>(new Ast::Cpp::Class::BaseRule, "serializable class", "CLASS(Serializable)");
+     * const auto result = ruleSet.Apply(trees, logCollector);
+     * @endcode
+     */
+    class RuleSet final : public Utils::CopyableAndMoveable
+    {
+    public:
+        struct Result final
+        {
+            Size checks = 0;
+            Size violations = 0;
+
+            Result& operator+=(const Result& other) noexcept
+            {
+                checks += other.checks;
+                violations += other.violations;
+                return *this;
+            }
+        };
+
+    public:
+        template<IsLexer Lexer>
+        void Add(Rule::CPtr rule, const String& additionalMessage = {}, const String& marker = {})
+        {
+            Add(String(Lexer::typeName), std::move(rule), additionalMessage, marker);
+        }
+
+        void Add(const String& lexerType, Rule::CPtr rule, const String& additionalMessage = {}, const String& marker = {});
+
+        [[nodiscard]] Size GetRulesCount() const noexcept { return _rulesCount; }
+        [[nodiscard]] Size GetMarkedRulesCount() const noexcept { return _markedRulesCount; }
+        [[nodiscard]] bool IsEmpty() const noexcept { return _rulesCount == 0; }
+        /**
+         * @brief Changes with any rule, its parameters, lexer type, message or marker
+         * @details Computed from the current state of the rules on every call, so a rule changed after Add (e.g. by
+         * OverrideLogType) gets a new hash. Apply computes it once per tree when a cache is given.
+         */
+        [[nodiscard]] RuleCache::Key GetProgramHash() const;
+
+        /// @param cache if given, the lexers unchanged since the cached run replay their results instead of checking
+        Result Apply(const ASTFileTree& tree, LogCollector& logCollector, RuleCache* cache = nullptr) const;
+
+        /// @brief applies the rules to the trees on threadsCount threads, 0 means a thread per hardware core
+        Result Apply(std::span<const ASTFileTree::CPtr> trees, LogCollector& logCollector, Size threadsCount = 0,
+                     RuleCache* cache = nullptr) const;
+
+    private:
+        struct Entry final
+        {
+            Rule::CPtr rule;
+            String additionalMessage;
+            String markerRule; ///< empty if any mark with the parameter fits
+        };
+
+        struct MarkerHash final
+        {
+            using is_transparent = void;
+
+            [[nodiscard]] std::size_t operator()(std::string_view param) const noexcept { return std::hash<std::string_view>{}(param); }
+        };
+
+        struct TypeRules final
+        {
+            String lexerType; ///< the type tags may differ between runs, the cached results are keyed by the names
+            std::vector<Entry> common;
+            std::unordered_map<std::string, std::vector<Entry>, MarkerHash, std::equal_to<>> marked; ///< by a parameter of a mark
+        };
+
+        static void ApplyToLexer(const TypeRules& typeRules, const BaseLexer* lexer, LogCollector& logCollector, Result& result);
+
+    private:
+        /// @brief rules of every lexer type, indexed by the type tag of the node table
+        std::vector<TypeRules> _rules;
+        Size _rulesCount = 0;
+        Size _markedRulesCount = 0;
+    };
+
+} // namespace Ast
\ No newline at end of file
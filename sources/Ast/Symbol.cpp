@@ -0,0 +1,193 @@
+// Copyright (c) 2024 Valerii Koniushenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "Symbol.h"
+
+#include "Core/Assert.h"
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Ast
+{
+
+    namespace
+    {
+        /**
+         * @brief Append-only storage of the interned strings
+         * @details Strings live in chunks which are never moved, each chunk is twice bigger than the previous one. So a symbol
+         * is resolved to its string without locking: a chunk is published before any id pointing into it can be handed out.
+         */
+        class SymbolTable final
+        {
+        public:
+            inline static constexpr Symbol::Id firstChunkBits = 6;
+            inline static constexpr Size maxChunks = std::numeric_limits<Symbol::Id>::digits - firstChunkBits;
+
+        public:
+            static SymbolTable& Get()
+            {
+                static SymbolTable table;
+                return table;
+            }
+
+            [[nodiscard]] Symbol::Id Intern(Symbol::StringView string)
+            {
+                if (const auto id = Find(string))
+                {
+                    return *id;
+                }
+
+                std::unique_lock lock(_mutex);
+                if (const auto it = _ids.find(string); it != _ids.end())
+                {
+                    return it->second;
+                }
+
+                const auto id = _count;
+                const auto [chunkIndex, offset] = GetLocation(id);
+                if (!Verify(chunkIndex < maxChunks, "The symbol table is full"))
+                {
+                    return Symbol::emptyId;
+                }
+
+                if (!_chunks[chunkIndex].load(std::memory_order_relaxed))
+                {
+                    _chunksCapacity += GetChunkSize(chunkIndex);
+                    _ownedChunks.push_back(std::make_unique<String[]>(GetChunkSize(chunkIndex)));
+                    _chunks[chunkIndex].store(_ownedChunks.back().get(), std::memory_order_release);
+                }
+
+                auto& stored = _chunks[chunkIndex].load(std::memory_order_relaxed)[offset];
+                stored = String(string.data(), string.size());
+                _ids.emplace(stored.ToStringView(), id);
+                _bytes += stored.Size() * sizeof(String::CharT);
+                ++_count;
+
+                return id;
+            }
+
+            [[nodiscard]] std::optional<Symbol::Id> Find(Symbol::StringView string) const
+            {
+                std::shared_lock lock(_mutex);
+                if (const auto it = _ids.find(string); it != _ids.end())
+                {
+                    return it->second;
+                }
+                return std::nullopt;
+            }
+
+            [[nodiscard]] const String& GetString(Symbol::Id id) const noexcept
+            {
+                const auto [chunkIndex, offset] = GetLocation(id);
+                return _chunks[chunkIndex].load(std::memory_order_acquire)[offset];
+            }
+
+            [[nodiscard]] Size GetCount() const
+            {
+                std::shared_lock lock(_mutex);
+                return _count;
+            }
+
+            [[nodiscard]] Size GetMemoryUsage() const
+            {
+                std::shared_lock lock(_mutex);
+                return sizeof(SymbolTable) + _chunksCapacity * sizeof(String) + _bytes +
+                       _ids.bucket_count() * sizeof(void*) + _ids.size() * (sizeof(Symbol::StringView) + sizeof(Symbol::Id) + sizeof(void*));
+            }
+
+        private:
+            [[nodiscard]] static constexpr Size GetChunkSize(Size chunkIndex) noexcept { return Size(1) << (chunkIndex + firstChunkBits); }
+
+            /// @brief chunk 0 holds ids [0, 64), chunk 1 holds [64, 192) and so on
+            [[nodiscard]] static constexpr std::pair<Size, Size> GetLocation(Symbol::Id id) noexcept
+            {
+                const auto biased = static_cast<Size>(id) + GetChunkSize(0);
+                const auto chunkIndex = static_cast<Size>(std::bit_width(biased)) - 1 - firstChunkBits;
+                return { chunkIndex, biased - GetChunkSize(chunkIndex) };
+            }
+
+            SymbolTable()
+            {
+                [[maybe_unused]] const auto id = Intern({});
+                Assert(id == Symbol::emptyId);
+            }
+
+        private:
+            mutable std::shared_mutex _mutex;
+            std::array<std::atomic<String*>, maxChunks> _chunks{};
+            std::vector<std::unique_ptr<String[]>> _ownedChunks;
+            std::unordered_map<Symbol::StringView, Symbol::Id> _ids; // views point into the chunks
+            Symbol::Id _count = 0;
+            Size _chunksCapacity = 0;
+            Size _bytes = 0;
+        };
+    } // namespace
+
+    Symbol::Symbol(StringView string)
+        : _id{ SymbolTable::Get().Intern(string) }
+    {
+    }
+
+    Symbol::Symbol(const String& string)
+        : Symbol(string.ToStringView())
+    {
+    }
+
+    Symbol Symbol::Find(StringView string)
+    {
+        Symbol symbol;
+        if (const auto id = SymbolTable::Get().Find(string))
+        {
+            symbol._id = *id;
+        }
+        return symbol;
+    }
+
+    const String& Symbol::GetString() const noexcept
+    {
+        return SymbolTable::Get().GetString(_id);
+    }
+
+    Symbol::StringView Symbol::ToStringView() const noexcept
+    {
+        return GetString().ToStringView();
+    }
+
+    Size Symbol::GetSymbolsCount()
+    {
+        return SymbolTable::Get().GetCount();
+    }
+
+    Size Symbol::GetMemoryUsage()
+    {
+        return SymbolTable::Get().GetMemoryUsage();
+    }
+
+} // namespace Ast
\ No newline at end of file
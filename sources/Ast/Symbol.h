@@ -0,0 +1,81 @@
+// Copyright (c) 2024 Valerii Koniushenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "CommonTypes.h"
+
+#include <cstdint>
+#include <functional>
+#include <string_view>
+
+namespace Ast
+{
+
+    /**
+     * @brief Interned string, a 32-bit id in the project-wide symbol table
+     * @details Equal strings are stored only once and share the id, so names repeated across lexers and files cost 4 bytes
+     * per use and comparing symbols is an integer compare. The table is thread-safe and append-only: interned strings live
+     * until the end of the program, so references returned by GetString() never dangle.
+     * @code
+     * const Symbol name("std::string");
+     * if (name == Symbol::Find(otherName)) { ... }
+     * @endcode
+     */
+    class Symbol final
+    {
+    public:
+        using Id = std::uint32_t;
+        using StringView = Ast::StringView;
+
+        inline static constexpr Id emptyId = 0;
+
+    public:
+        Symbol() = default;
+        explicit Symbol(StringView string);
+        explicit Symbol(const String& string);
+
+        /// @brief looks the string up without interning it, returns an empty symbol if the string wasn't interned yet
+        [[nodiscard]] static Symbol Find(StringView string);
+
+        [[nodiscard]] Id GetId() const noexcept { return _id; }
+        [[nodiscard]] bool IsEmpty() const noexcept { return _id == emptyId; }
+        [[nodiscard]] const String& GetString() const noexcept;
+        [[nodiscard]] StringView ToStringView() const noexcept;
+        [[nodiscard]] const String::CharT* c_str() const noexcept { return GetString().c_str(); }
+
+        [[nodiscard]] bool operator==(const Symbol& other) const noexcept = default;
+        [[nodiscard]] bool operator==(StringView other) const noexcept { return ToStringView() == other; }
+
+        [[nodiscard]] static Size GetSymbolsCount();
+        /// @brief bytes held by the whole table, it's shared by all the trees so it isn't a part of a tree report
+        [[nodiscard]] static Size GetMemoryUsage();
+
+    private:
+        Id _id = emptyId;
+    };
+
+} // namespace Ast
+
+template<>
+struct std::hash<Ast::Symbol>
+{
+    [[nodiscard]] std::size_t operator()(const Ast::Symbol& symbol) const noexcept { return std::hash<Ast::Symbol::Id>{}(symbol.GetId()); }
+};
\ No newline at end of file
@@ -25,18 +25,17 @@ namespace Ast
 
     std::ostream& Print(std::ostream& stream, const Ast::ASTFileTree& tree)
     {
-        tree.ForEach(
-            [&](const Ast::BaseLexer* lexer, Ast::ASTFileTree::Params params)
+        const auto pinnedTable = tree.GetNodeTable();
+        const auto& nodeTable = *pinnedTable;
+        for (NodeTable::NodeId node = 0; node < nodeTable.GetSize(); ++node)
+        {
+            stream << "> ";
+            for (int i = 0; i < nodeTable.GetNesting(node); ++i)
             {
-                stream << "> ";
-                for (int i = 0; i < params.nesting; ++i)
-                {
-                    stream << "\t";
-                }
-                stream << lexer->GetLexerName().c_str() << std::endl;
-
-                return true;
-            });
+                stream << "\t";
+            }
+            stream << nodeTable.GetName(node) << std::endl;
+        }
 
         return stream;
     }
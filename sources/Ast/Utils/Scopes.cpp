@@ -20,6 +20,10 @@
 
 #include "Scopes.h"
 
+#include "Ast/Readers/ContentStream.h"
+
+#include <algorithm>
+
 namespace Ast::Utils
 {
 
@@ -140,4 +144,110 @@ namespace Ast::Utils
         return bracketCounter != 0;
     }
 
+    namespace
+    {
+        /// @brief walks forward over the characters of a stream which aren't masked
+        class UnmaskedCursor final
+        {
+        public:
+            UnmaskedCursor(const ContentStream& stream, const String::CharT* position)
+                : _begin{ stream.Data().c_str() },
+                  _ranges{ stream.GetMask().GetRanges() },
+                  _position{ stream.SkipMasked(position) }
+            {
+                _nextRange = std::ranges::upper_bound(_ranges, static_cast<Size>(_position - _begin), {},
+                                                      [](const ContentMask::Range& range) { return Size{ range.begin }; });
+            }
+
+            [[nodiscard]] const String::CharT* Get() const noexcept { return _position; }
+
+            void Next() noexcept
+            {
+                ++_position;
+                if (_nextRange != _ranges.end() && _position == _begin + _nextRange->begin)
+                {
+                    _position = _begin + _nextRange->end;
+                    ++_nextRange;
+                }
+            }
+
+        private:
+            const String::CharT* _begin = nullptr;
+            const std::vector<ContentMask::Range>& _ranges;
+            std::vector<ContentMask::Range>::const_iterator _nextRange;
+            const String::CharT* _position = nullptr;
+        };
+    } // namespace
+
+    const String::CharT* FindClosedBracket(const ContentStream& stream, const String::CharT* source, String::CharT closedBracket,
+                                           String::CharT openedBracket)
+    {
+        if (stream.GetMask().IsEmpty())
+        {
+            return FindClosedBracket(source, closedBracket, openedBracket);
+        }
+
+        if (!Verify(source, "Impossible to find the first bracket because was passed the NULL string"))
+        {
+            return nullptr;
+        }
+
+        UnmaskedCursor cursor(stream, source);
+
+        // skipping of the opened bracket
+        if (*cursor.Get() == openedBracket)
+        {
+            cursor.Next();
+        }
+
+        std::size_t bracketCounter = 1;
+        for (; *cursor.Get() != 0; cursor.Next())
+        {
+            if (*cursor.Get() == openedBracket)
+            {
+                ++bracketCounter;
+            }
+            else if (*cursor.Get() == closedBracket && --bracketCounter == 0)
+            {
+                return cursor.Get();
+            }
+        }
+
+        return nullptr;
+    }
+
+    bool HasUnclosedBracket(const ContentStream& stream, const String::CharT* from, const String::CharT* to, String::CharT closedBracket,
+                            String::CharT openedBracket)
+    {
+        if (stream.GetMask().IsEmpty())
+        {
+            return HasUnclosedBracket(from, to, closedBracket, openedBracket);
+        }
+
+        if (!Verify(from && to && from < to, "Impossible to find the unclosed bracket because was passed a wrong range"))
+        {
+            return false;
+        }
+
+        if (*from == openedBracket)
+        {
+            ++from;
+        }
+
+        std::size_t bracketCounter = 0;
+        for (UnmaskedCursor cursor(stream, from); cursor.Get() < to; cursor.Next())
+        {
+            if (*cursor.Get() == openedBracket)
+            {
+                ++bracketCounter;
+            }
+            else if (*cursor.Get() == closedBracket)
+            {
+                --bracketCounter;
+            }
+        }
+
+        return bracketCounter != 0;
+    }
+
 } // namespace Ast::Utils
\ No newline at end of file
@@ -22,6 +22,11 @@
 
 #include "../CommonTypes.h"
 
+namespace Ast
+{
+    class ContentStream;
+} // namespace Ast
+
 namespace Ast::Utils
 {
 
@@ -31,4 +36,11 @@ namespace Ast::Utils
     [[nodiscard]] bool HasUnclosedBracket(const String::CharT* from, const String::CharT* to, String::CharT closedBracket,
                                           String::CharT openedBracket);
 
+    // the same as above, but the brackets inside of the ranges masked in the stream (comments, literals...) are skipped
+
+    [[nodiscard]] const String::CharT* FindClosedBracket(const ContentStream& stream, const String::CharT* source, String::CharT closedBracket,
+                                                         String::CharT openedBracket);
+    [[nodiscard]] bool HasUnclosedBracket(const ContentStream& stream, const String::CharT* from, const String::CharT* to,
+                                          String::CharT closedBracket, String::CharT openedBracket);
+
 } // namespace Ast::Utils
\ No newline at end of file
@@ -22,6 +22,8 @@
 
 #include "../Lexers/BaseLexer.h"
 
+#include <cctype>
+
 namespace Ast::Utils
 {
     const String::CharT* SkipBracketsR(const BaseLexer* lexer, const String::CharT* str, String::CharT openBracket, String::CharT closedBracket)
@@ -58,4 +60,65 @@ namespace Ast::Utils
         return ++str;
     }
 
+
+    bool IsWordChar(String::CharT ch) noexcept
+    {
+        return std::isalnum(static_cast<unsigned char>(ch)) || ch == '_';
+    }
+
+    StringView TrimView(StringView view) noexcept
+    {
+        while (!view.empty() && String::IsSpace(view.front()))
+        {
+            view.remove_prefix(1);
+        }
+        while (!view.empty() && String::IsSpace(view.back()))
+        {
+            view.remove_suffix(1);
+        }
+        return view;
+    }
+
+    StringView ReadWord(StringView& view) noexcept
+    {
+        Size size = 0;
+        while (size < view.size() && IsWordChar(view[size]))
+        {
+            ++size;
+        }
+
+        const auto word = view.substr(0, size);
+        view.remove_prefix(size);
+        return word;
+    }
+
+    bool ConsumeWord(StringView& view, StringView word) noexcept
+    {
+        auto rest = TrimView(view);
+        if (!rest.starts_with(word) || (rest.size() > word.size() && IsWordChar(rest[word.size()])))
+        {
+            return false;
+        }
+
+        rest.remove_prefix(word.size());
+        view = TrimView(rest);
+        return true;
+    }
+
+    StringView NormalizeLineBreaks(StringView view)
+    {
+        if (view.find_first_of("\r\n") == StringView::npos)
+        {
+            return view;
+        }
+
+        thread_local String scratch;
+        scratch.Clear();
+        for (const auto ch : view)
+        {
+            scratch.PushBack(ch == '\n' || ch == '\r' ? ' ' : ch);
+        }
+        return scratch.ToStringView();
+    }
+
 } // namespace Ast::Utils
\ No newline at end of file
@@ -33,4 +33,60 @@ namespace Ast::Utils
     /// @brief pass ptr to the 'closedBracket'
     const String::CharT* SkipBracketsR(const BaseLexer* lexer, const String::CharT* str, String::CharT openBracket, String::CharT closedBracket);
 
+    // ===========================================================
+    // ================ WORKING WITH STRING VIEWS ================
+    // ===========================================================
+
+    /// @brief \w in terms of regex
+    [[nodiscard]] bool IsWordChar(String::CharT ch) noexcept;
+
+    [[nodiscard]] StringView TrimView(StringView view) noexcept;
+
+    /// @brief reads leading \w+ and removes it from the view
+    [[nodiscard]] StringView ReadWord(StringView& view) noexcept;
+
+    /// @brief removes the leading 'word' and whitespaces around it. The view stays untouched if it isn't started from the word
+    bool ConsumeWord(StringView& view, StringView word) noexcept;
+
+    /**
+     * @brief Copies the view to the per-thread scratch buffer replacing line breaks with spaces
+     * @details The buffer is reused by the next call on the same thread, so the result has to be materialized (e.g. interned)
+     * before that. If there is nothing to replace the view itself is returned and nothing is copied.
+     */
+    [[nodiscard]] StringView NormalizeLineBreaks(StringView view);
+
+    /// @brief calls 'callback' for every not empty trimmed part of the view, separators inside of angle brackets are skipped
+    template<class Callback>
+    void SplitTopLevel(StringView view, String::CharT separator, Callback&& callback)
+    {
+        int depth = 0;
+        Size partBegin = 0;
+        for (Size i = 0; i <= view.size(); ++i)
+        {
+            if (i < view.size())
+            {
+                if (view[i] == '<')
+                {
+                    ++depth;
+                    continue;
+                }
+                if (view[i] == '>')
+                {
+                    --depth;
+                    continue;
+                }
+                if (view[i] != separator || depth != 0)
+                {
+                    continue;
+                }
+            }
+
+            if (const auto part = TrimView(view.substr(partBegin, i - partBegin)); !part.empty())
+            {
+                callback(part);
+            }
+            partBegin = i + 1;
+        }
+    }
+
 } // namespace Ast::Utils
\ No newline at end of file
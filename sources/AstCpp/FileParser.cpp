@@ -20,181 +20,57 @@
 
 #include "AstCpp/FileParser.h"
 
-#include "Readers/ClassReader.h"
-#include "Readers/EnumClassReader.h"
-#include "Readers/NamespaceReader.h"
-
+#include <algorithm>
 #include <filesystem>
+#include <utility>
 
 namespace Ast::Cpp
 {
 
-    bool FileParser::Parse(const ContentStream::Ptr& file, LogCollector& logCollector)
-    {
-        RawParse(file, logCollector);
-        BindScopes(logCollector);
-        return true;
-    }
-
-    void FileParser::RawParse(const ContentStream::Ptr& reader, LogCollector& logCollector)
+    void FileParserBase::BindScopes(std::vector<BaseLexer*> lexers, const LexerSideTables& sideTables, LogCollector& logCollector)
     {
-        ReadAs<NamespaceLexer, NamespaceReader>(_namespaceLexers, reader, logCollector);
-        ReadAs<ClassLexer, ClassReader>(_classLexers, reader, logCollector);
-        ReadAs<EnumClassLexer, EnumClassReader>(_enumClassLexers, reader, logCollector);
-    }
-
-    void FileParser::BindScopes(LogCollector& logCollector)
-    {
-        BaseLexer* lexer = BindScopesForLexer(nullptr, logCollector);
-        while ((lexer = FindNextLexer(lexer)))
+        // ordered by the opened brackets, so every lexer goes after all the lexers which contain it
+        std::erase_if(lexers,
+                      [](const BaseLexer* lexer)
+                      {
+                          const auto scope = lexer ? lexer->GetOpenScope() : std::nullopt;
+                          return !scope || !scope->IsValid() || !lexer->GetCloseScope();
+                      });
+        std::ranges::sort(lexers, {}, [](const BaseLexer* lexer) { return lexer->GetOpenScope()->string; });
+
+        // lexers which contain the current one, the innermost is on the top
+        std::vector<BaseLexer*> scopes;
+        for (auto* lexer : lexers)
         {
-            lexer = BindScopesForLexer(lexer, logCollector);
-        }
-
-        String path;
-        if (const auto filePath = GetFilePath())
-        {
-            path = filePath->string();
-        }
-        else
-        {
-            path = String("none");
-        }
-
-        logCollector.AddLog(
-            { String::Format("Successfully was build binding between lexers at file: '{}'", path.c_str()), LogCollector::LogType::Success });
-    }
-
-    BaseLexer* FileParser::BindScopesForLexer(BaseLexer* prevLexer, LogCollector& logCollector)
-    {
-        const auto startChildsCount = prevLexer ? prevLexer->GetChildLexers().size() : 0;
-        IterateOverLexers(
-            [&](BaseLexer* lexer)
+            // the unbound lexers become children of the file lexer
+            if (sideTables.IsStopRequested())
             {
-                if (!lexer || lexer == prevLexer)
-                {
-                    return true;
-                }
-
-                if (const auto scope = lexer->GetOpenScope(); scope && scope->IsValid())
-                {
-                    if (!prevLexer)
-                    {
-                        prevLexer = lexer;
-                    }
-                    else
-                    {
-                        auto prevLexerName = prevLexer->GetLexerName();
-                        auto lexerName = lexer->GetLexerName();
-
-                        if (prevLexer->IsContainLexer(lexer, true))
-                        {
-                            BindScopesForLexer(lexer, logCollector);
-                            if (!lexer->HasParent())
-                            {
-                                prevLexer->TryToSetAsChild(lexer);
-                            }
-                        }
-                    }
-                }
-
-                return true;
-            });
-
-        if (!prevLexer || prevLexer->GetChildLexers().size() == startChildsCount)
-        {
-            return nullptr;
-        }
-
-        return prevLexer;
-    }
-
-    BaseLexer* FileParser::FindNextLexer(const BaseLexer* prevLexer)
-    {
-        if (!prevLexer)
-        {
-            return nullptr;
-        }
-
-        BaseLexer* nearestLexer = nullptr;
+                return;
+            }
 
-        // find any first lexer after 'prevLexer'
-        IterateOverLexers(
-            [&](BaseLexer* lexer)
+            while (!scopes.empty() && !scopes.back()->IsContainLexer(lexer))
             {
-                if (!Verify(lexer) || *lexer == *prevLexer)
-                {
-                    return true;
-                }
-
-                const auto distance = prevLexer->GetDistanceToLexer(lexer);
-                if (!prevLexer->IsContainLexer(lexer) && distance > 0)
-                {
-                    nearestLexer = lexer;
-                    return false;
-                }
-                return true;
-            });
-
-        if (!nearestLexer)
-        {
-            return nullptr;
-        }
+                scopes.pop_back();
+            }
 
-        IterateOverLexers(
-            [&](BaseLexer* lexer)
+            if (!scopes.empty() && !lexer->HasParent())
             {
-                if (!lexer)
-                {
-                    return true;
-                }
-
-                if (prevLexer->IsContainLexer(lexer) || *prevLexer == *lexer)
-                {
-                    return true;
-                }
-
-                const auto d1 = prevLexer->GetDistanceToLexer(lexer);
-                const auto d2 = prevLexer->GetDistanceToLexer(nearestLexer);
-                if (d1 < d2)
-                {
-                    nearestLexer = lexer;
-                }
-
-                return true;
-            });
-
-        return nearestLexer;
-    }
+                scopes.back()->TryToSetAsChild(lexer);
+            }
+            scopes.push_back(lexer);
+        }
 
-    void FileParser::IterateOverLexers(std::function<bool(BaseLexer*)>&& callback)
-    {
-        if (!callback)
+        if (!logCollector.IsEnabled(LogCollector::LogType::Success))
         {
             return;
         }
 
-        for (auto&& lexer : _classLexers)
-        {
-            if (!callback(lexer.get()))
-            {
-                return;
-            }
-        }
-        for (auto&& lexer : _namespaceLexers)
-        {
-            if (!callback(lexer.get()))
-            {
-                return;
-            }
-        }
-        for (auto&& lexer : _enumClassLexers)
+        auto logLine = LogCollector::LogLine::MakeEvent(LogCollector::EventCode::ScopesBound, LogCollector::LogType::Success);
+        if (const auto filePath = GetFilePath())
         {
-            if (!callback(lexer.get()))
-            {
-                return;
-            }
+            logLine.file = Symbol(StringView(filePath->string()));
         }
+        logCollector.AddLog(std::move(logLine));
     }
 
 } // namespace Ast::Cpp
\ No newline at end of file
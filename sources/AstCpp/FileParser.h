@@ -21,41 +21,47 @@
 #pragma once
 
 #include "Ast/FileParser.h"
+#include "Ast/Readers/AnchoredRegexTokenReaderImpl.h"
 #include "Ast/Readers/BaseTokenReader.h"
-#include "Lexers/ClassLexer.h"
-#include "Lexers/EnumClassLexer.h"
-#include "Lexers/NamespaceLexer.h"
+#include "Ast/Readers/ContentStream.h"
+#include "Readers/DeclarationTraits.h"
+#include "Readers/KeywordPrefilter.h"
+#include "Readers/MarkerScanner.h"
 
+#include <array>
+#include <tuple>
+#include <utility>
 #include <vector>
 
-namespace Ast
-{
-    class ContentStream;
-} // namespace Ast
-
 namespace Ast::Cpp
 {
 
-    class FileParser final : public Ast::FileParser
+    /// @brief the part of FileParserT which doesn't depend on the lexer types
+    class FileParserBase : public Ast::FileParser
     {
     public:
         template<class T>
         using Container = std::vector<boost::intrusive_ptr<T>>;
 
-    public:
-        FileParser() = default;
-        ~FileParser() override = default;
-
-        bool Parse(const ContentStream::Ptr& file, LogCollector& logCollector) override;
-        void IterateOverLexers(std::function<bool(BaseLexer*)>&& callback) override;
-
     protected:
         template<IsLexer Lexer, IsReader ReaderT>
-        static void ReadAs(Container<Lexer>& container, const ContentStream::Ptr& reader, LogCollector& logCollector)
+        static void ReadAs(Container<Lexer>& container, const LexerSideTables::Ptr& sideTables,
+                           const AnchoredRegexTokenReaderImpl::Anchors& anchors, LogCollector& logCollector)
         {
-            for (auto&& token : ReaderT(reader))
+            if (!sideTables->GetParseOptions().IsRequested(Lexer::typeName))
             {
-                auto lexer = Lexer::Create(reader);
+                return;
+            }
+
+            const auto reader = sideTables->GetReader();
+            for (auto&& token : ReaderT(reader, anchors))
+            {
+                if (sideTables->IsStopRequested())
+                {
+                    return;
+                }
+
+                auto lexer = Lexer::Create(reader, sideTables);
                 lexer->SetToken(token);
                 if (lexer->Validate(logCollector))
                 {
@@ -64,16 +70,108 @@ namespace Ast::Cpp
             }
         }
 
+        /// @brief binds every lexer to the nearest lexer which contains it, stops when the side tables say so
+        void BindScopes(std::vector<BaseLexer*> lexers, const LexerSideTables& sideTables, LogCollector& logCollector);
+    };
+
+    /**
+     * @brief Parses the lexer types listed at compile time, e.g: FileParserT<ClassLexer, EnumClassLexer>
+     * @details Storage, reading and iteration are generated only for the listed types, so nothing is spent on the others: their
+     * keywords aren't even searched. Candidates of all the types are found in one pass over the content (KeywordPrefilter or
+     * MarkerScanner), then every reader matches only its own candidates. A type is described by its DeclarationTraits.
+     */
+    template<IsLexer... Lexers>
+    class FileParserT final : public FileParserBase
+    {
+    public:
+        FileParserT() = default;
+        ~FileParserT() override = default;
+
+        bool Parse(const LexerSideTables::Ptr& sideTables, LogCollector& logCollector) override
+        {
+            if (!Verify(!!sideTables, "Side tables were nullptr"))
+            {
+                logCollector.AddLog({ "FileParser: side tables were nullptr", LogCollector::LogType::Error });
+                return false;
+            }
+
+            const auto reader = sideTables->GetReader();
+            if (sideTables->GetParseOptions().markedOnly)
+            {
+                ReadDeclarations(MarkerScanner(reader->Data(), markers, reader->GetMask()), sideTables, logCollector);
+            }
+            else if (const KeywordPrefilter prefilter(reader->Data(), keywords, reader->GetMask()); !prefilter.IsEmpty())
+            {
+                ReadDeclarations(prefilter, sideTables, logCollector);
+            }
+
+            std::vector<BaseLexer*> lexers;
+            ForEachLexer(
+                [&lexers](BaseLexer* lexer)
+                {
+                    lexers.push_back(lexer);
+                    return true;
+                });
+            BindScopes(std::move(lexers), *sideTables, logCollector);
+
+            return true;
+        }
+
+        void IterateOverLexers(std::function<bool(BaseLexer*)>&& callback) override
+        {
+            if (callback)
+            {
+                ForEachLexer(callback);
+            }
+        }
+
+        /// @brief calls 'callback' with a pointer to the exact type of every lexer until it returns false
+        template<class Callback>
+        bool ForEachLexer(Callback&& callback)
+        {
+            return (ForEachLexerOf<Lexers>(callback) && ...);
+        }
+
+        template<IsLexer Lexer>
+        [[nodiscard]] const Container<Lexer>& GetLexers() const noexcept
+        {
+            return std::get<Container<Lexer>>(_lexers);
+        }
+
     private:
-        void RawParse(const ContentStream::Ptr& file, LogCollector& logCollector);
-        void BindScopes(LogCollector& logCollector);
-        BaseLexer* BindScopesForLexer(BaseLexer* prevLexer, LogCollector& logCollector);
-        BaseLexer* FindNextLexer(const BaseLexer* prevLexer);
+        template<IsLexer Lexer, class Callback>
+        bool ForEachLexerOf(Callback& callback)
+        {
+            for (auto&& lexer : std::get<Container<Lexer>>(_lexers))
+            {
+                if (!callback(lexer.get()))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        /// @brief 'scanner' gives the candidates of every type by its index in 'Lexers'
+        template<class Scanner>
+        void ReadDeclarations(const Scanner& scanner, const LexerSideTables::Ptr& sideTables, LogCollector& logCollector)
+        {
+            [&]<Size... Indices>(std::index_sequence<Indices...>)
+            {
+                (ReadAs<Lexers, typename DeclarationTraits<Lexers>::Reader>(std::get<Indices>(_lexers), sideTables,
+                                                                            scanner.GetDeclarations(Indices), logCollector),
+                 ...);
+            }(std::index_sequence_for<Lexers...>{});
+        }
 
     private:
-        Container<ClassLexer> _classLexers;
-        Container<NamespaceLexer> _namespaceLexers;
-        Container<EnumClassLexer> _enumClassLexers;
+        static constexpr std::array<StringView, sizeof...(Lexers)> keywords = { DeclarationTraits<Lexers>::keyword... };
+        static constexpr std::array<StringView, sizeof...(Lexers)> markers = { DeclarationTraits<Lexers>::marker... };
+
+        std::tuple<Container<Lexers>...> _lexers;
     };
 
+    /// @brief parses all the C++ lexers of the library
+    using FileParser = FileParserT<ClassLexer, NamespaceLexer, EnumClassLexer>;
+
 } // namespace Ast::Cpp
\ No newline at end of file
@@ -21,102 +21,373 @@
 #include "ClassLexer.h"
 
 #include "Ast/LogCollector.h"
+#include "Ast/MemoryUsage.h"
 #include "Ast/Readers/ContentStream.h"
 #include "Ast/Utils/Scopes.h"
 #include "Ast/Utils/String.h"
 #include "AstCpp/TemplateLexer/CheckForTemplateLexer.h"
 
+#include <algorithm>
+#include <array>
+#include <optional>
+#include <string_view>
+
 namespace Ast::Cpp
 {
 
-    ClassLexer::ClassLexer(const ContentStream::Ptr& fileReader)
-        : BaseLexer(fileReader, typeName)
-    {
-    }
-
-    bool ClassLexer::DoValidate(LogCollector& logCollector)
+    namespace
     {
-        if (!Verify(_token.IsValid(), "Impossible to work with an invalid token"))
+        struct QualifierKeyword
         {
-            logCollector.AddLog({ "ClassLexer: Impossible to work with an invalid token", LogCollector::LogType::Error });
-            return false;
-        }
+            StringView keyword;
+            bool ClassLexer::Field::* flag = nullptr;
+        };
 
-        String string(_token.beginData, _token.endData - _token.beginData);
-        string.RegexReplace(R"(\n|\r|(class)|\{)", " ");
-        string.Trim(' ');
-        if (string.IsEmpty())
+        struct AccessKeyword
         {
-            logCollector.AddLog({ String::Format("Impossible to parse the class token at {}", _token.startLine), LogCollector::LogType::Error });
-            return false;
-        }
-
-        if (string.RegexReplace("\\sfinal", ""))
+            StringView keyword;
+            ClassLexer::AccessSpecifier accessSpecifier = ClassLexer::AccessSpecifier::Private;
+        };
+
+        constexpr std::array qualifierKeywords{
+            QualifierKeyword{ "static", &ClassLexer::Field::isStatic },
+            QualifierKeyword{ "const", &ClassLexer::Field::isConst },
+            QualifierKeyword{ "constexpr", &ClassLexer::Field::isConstexpr },
+            QualifierKeyword{ "constinit", &ClassLexer::Field::isConstinit },
+        };
+
+        constexpr std::array accessKeywords{
+            AccessKeyword{ "public", ClassLexer::AccessSpecifier::Public },
+            AccessKeyword{ "protected", ClassLexer::AccessSpecifier::Protected },
+            AccessKeyword{ "private", ClassLexer::AccessSpecifier::Private },
+        };
+
+        // declarations which look like '<type> <name> = ...' but aren't fields
+        constexpr std::array<StringView, 8> notTypeKeywords{ "using", "typedef", "friend", "template", "class", "struct", "union", "enum" };
+
+        /**
+         * @brief Single forward pass over a class body which recognizes fields like '[qualifiers] type<...> name [= ...];'
+         * @details The body is a span of the original buffer. Every statement ends at ';' or at the line end, nested scopes
+         * (method bodies, nested classes, brace initializers) are jumped over by bracket matching. The current access specifier
+         * is tracked along the way. Ranges masked in the content (comments, literals) are treated as whitespaces.
+         */
+        class FieldScanner final
         {
-            _hasFinal = true;
-        }
+        public:
+            FieldScanner(StringView body, const ContentStream& stream) noexcept
+                : _body{ body },
+                  _bodyOffset{ static_cast<Size>(body.data() - stream.Data().c_str()) },
+                  _mask{ stream.GetMask() }
+            {
+            }
 
-        auto match = string.FindRegex("^\\w+");
-        if (Verify(!match.empty(), "Impossible to define a class name"))
-        {
-            _lexerName = match.str();
-            _lexerName.ShrinkToFit();
-        }
-        else
-        {
-            logCollector.AddLog({ "Impossible to parse class token at {line}" });
-            return false;
-        }
+            template<class Callback>
+            void Scan(Callback&& onField)
+            {
+                auto accessSpecifier = ClassLexer::AccessSpecifier::Private;
+                while (SkipSpaces())
+                {
+                    if (const auto access = TryReadAccessSpecifier())
+                    {
+                        accessSpecifier = *access;
+                        continue;
+                    }
 
-        if (string.RegexReplace(R"(^\w+\s*:)", ""))
-        {
-            std::vector<String> parents;
-            int bracketsCount = 0;
-            String tmp;
-            for (int i = 0; i < string.Size(); ++i)
+                    const auto statementBegin = _position;
+
+                    ClassLexer::Field field;
+                    field.accessSpecifier = accessSpecifier;
+                    if (TryReadField(field))
+                    {
+                        onField(std::move(field));
+                    }
+                    else
+                    {
+                        _position = statementBegin;
+                    }
+
+                    SkipStatement();
+                }
+            }
+
+        private:
+            [[nodiscard]] bool IsEnd() const noexcept { return _position >= _body.size(); }
+            [[nodiscard]] String::CharT Current() const noexcept { return IsEnd() ? '\0' : _body[_position]; }
+
+            bool SkipSpaces() noexcept
+            {
+                while (!IsEnd())
+                {
+                    if (String::IsSpace(_body[_position]))
+                    {
+                        ++_position;
+                    }
+                    else if (!SkipMasked())
+                    {
+                        break;
+                    }
+                }
+                return !IsEnd();
+            }
+
+            /// @brief moves past the masked range which covers the current position
+            bool SkipMasked() noexcept
+            {
+                if (_mask.IsEmpty() || IsEnd())
+                {
+                    return false;
+                }
+
+                const auto end = _mask.Skip(_bodyOffset + _position) - _bodyOffset;
+                if (end == _position)
+                {
+                    return false;
+                }
+
+                _position = std::min(end, _body.size());
+                return true;
+            }
+
+            StringView ReadWhile(bool (*predicate)(String::CharT) noexcept) noexcept
             {
-                if (string[i] == '<')
+                const auto begin = _position;
+                while (!IsEnd() && predicate(_body[_position]))
                 {
-                    ++bracketsCount;
+                    ++_position;
                 }
-                else if (string[i] == '>')
+                return _body.substr(begin, _position - begin);
+            }
+
+            [[nodiscard]] StringView ReadWord() noexcept { return ReadWhile(&Utils::IsWordChar); }
+
+            [[nodiscard]] std::optional<ClassLexer::AccessSpecifier> TryReadAccessSpecifier() noexcept
+            {
+                const auto begin = _position;
+                const auto word = ReadWord();
+                if (const auto it = std::ranges::find(accessKeywords, word, &AccessKeyword::keyword); it != accessKeywords.end())
                 {
-                    --bracketsCount;
+                    SkipSpaces();
+                    if (Current() == ':' && (_position + 1 >= _body.size() || _body[_position + 1] != ':'))
+                    {
+                        ++_position;
+                        return it->accessSpecifier;
+                    }
                 }
-                tmp.PushBack(string[i]);
 
-                if (bracketsCount == 0)
+                _position = begin;
+                return std::nullopt;
+            }
+
+            /// @brief moves past the matching '>', nested angle brackets are taken into account
+            bool SkipTemplateArguments() noexcept
+            {
+                int depth = 0;
+                for (; !IsEnd(); ++_position)
                 {
-                    if (string[i] == ',')
+                    if (SkipMasked() && IsEnd())
+                    {
+                        return false;
+                    }
+
+                    const auto ch = _body[_position];
+                    if (ch == '<')
+                    {
+                        ++depth;
+                    }
+                    else if (ch == '>' && --depth == 0)
                     {
-                        tmp.Trim(',').Trim(' ');
-                        parents.push_back(std::move(tmp));
+                        ++_position;
+                        return true;
+                    }
+                    else if (ch == ';' || ch == '{' || ch == '}')
+                    {
+                        return false;
                     }
                 }
+                return false;
             }
-            parents.push_back(std::move(tmp));
 
-            for (auto&& parentStr : parents)
+            bool TryReadField(ClassLexer::Field& field)
             {
-                InheritanceType type = InheritanceType::Private;
-                if (parentStr.RegexReplace(R"(\s*public\s*)", ""))
+                auto word = ReadWord();
+                while (const auto* qualifier = FindQualifier(word))
+                {
+                    field.*(qualifier->flag) = true;
+                    if (!String::IsSpace(Current()) || !SkipSpaces())
+                    {
+                        return false;
+                    }
+                    word = ReadWord();
+                }
+
+                if (std::ranges::find(notTypeKeywords, word) != notTypeKeywords.end())
+                {
+                    return false;
+                }
+
+                // type: [\w:]+ with optional template arguments
+                const auto typeBegin = _position - word.size();
+                ReadWhile([](String::CharT ch) noexcept { return Utils::IsWordChar(ch) || ch == ':'; });
+                if (_position == typeBegin || (Current() == '<' && !SkipTemplateArguments()))
+                {
+                    return false;
+                }
+                const auto type = _body.substr(typeBegin, _position - typeBegin);
+
+                if (!String::IsSpace(Current()) || !SkipSpaces())
+                {
+                    return false;
+                }
+
+                const auto name = ReadWord();
+                if (name.empty())
                 {
-                    type = InheritanceType::Public;
+                    return false;
                 }
-                else if (parentStr.RegexReplace(R"(\s*protected\s*)", ""))
+
+                SkipSpaces();
+                if (Current() != ';' && Current() != '=' && Current() != '{')
                 {
-                    type = InheritanceType::Protected;
+                    return false;
                 }
-                else
+
+                field.type = Symbol(type);
+                field.name = Symbol(name);
+                return true;
+            }
+
+            [[nodiscard]] static const QualifierKeyword* FindQualifier(StringView word) noexcept
+            {
+                const auto it = std::ranges::find(qualifierKeywords, word, &QualifierKeyword::keyword);
+                return it != qualifierKeywords.end() ? &*it : nullptr;
+            }
+
+            /// @brief moves past the '}' which closes the scope opened at the current position
+            void SkipScope() noexcept
+            {
+                int depth = 0;
+                for (; !IsEnd(); ++_position)
                 {
-                    parentStr.RegexReplace(R"(\s*private\s*)", "");
-                    type = InheritanceType::Private;
+                    if (SkipMasked() && IsEnd())
+                    {
+                        return;
+                    }
+
+                    const auto ch = _body[_position];
+                    if (ch == '{')
+                    {
+                        ++depth;
+                    }
+                    else if (ch == '}' && --depth == 0)
+                    {
+                        ++_position;
+                        return;
+                    }
                 }
+            }
+
+            /// @brief moves to the next statement: past the nearest ';' or the line end outside of nested scopes
+            void SkipStatement() noexcept
+            {
+                while (!IsEnd())
+                {
+                    if (SkipMasked())
+                    {
+                        continue;
+                    }
+
+                    const auto ch = _body[_position];
+                    if (ch == '{')
+                    {
+                        SkipScope();
+                        continue;
+                    }
 
-                parentStr.Trim(' ');
-                parentStr.ShrinkToFit();
-                _parents.emplace_back(type, std::move(parentStr));
+                    ++_position;
+                    if (ch == ';' || ch == '\n')
+                    {
+                        return;
+                    }
+                }
             }
+
+        private:
+            StringView _body;
+            Size _bodyOffset = 0;
+            const ContentMask& _mask;
+            Size _position = 0;
+        };
+    } // namespace
+
+    ClassLexer::ClassLexer(const ContentStream::Ptr& fileReader, const LexerSideTables::Ptr& sideTables)
+        : BaseLexer(fileReader, sideTables, typeName)
+    {
+    }
+
+    bool ClassLexer::DoValidate(LogCollector& logCollector)
+    {
+        const auto& token = GetTokenReader();
+        if (!Verify(token.IsValid(), "Impossible to work with an invalid token"))
+        {
+            logCollector.AddLog({ "ClassLexer: Impossible to work with an invalid token", LogCollector::LogType::Error });
+            return false;
+        }
+
+        // e.g: 'class Name final : public Base<T>, private Interface {'
+        StringView view(token.beginData, token.endData - token.beginData);
+        Utils::ConsumeWord(view, "class");
+        if (view.ends_with('{'))
+        {
+            view.remove_suffix(1);
+        }
+        view = Utils::TrimView(view);
+        if (view.empty())
+        {
+            logCollector.AddLog({ String::Format("Impossible to parse the class token at {}", token.startLine), LogCollector::LogType::Error });
+            return false;
+        }
+
+        const auto name = Utils::ReadWord(view);
+        if (Verify(!name.empty(), "Impossible to define a class name"))
+        {
+            _lexerName = Symbol(name);
+        }
+        else
+        {
+            logCollector.AddLog({ "Impossible to parse class token at {line}" });
+            return false;
+        }
+
+        if (Utils::ConsumeWord(view, "final"))
+        {
+            _hasFinal = true;
+        }
+
+        view = Utils::TrimView(view);
+        if (view.starts_with(':'))
+        {
+            view.remove_prefix(1);
+
+            auto& details = GetColdData<Details>();
+            Utils::SplitTopLevel(view, ',',
+                                 [&details](StringView parent)
+                                 {
+                                     InheritanceType type = InheritanceType::Private;
+                                     if (Utils::ConsumeWord(parent, "public"))
+                                     {
+                                         type = InheritanceType::Public;
+                                     }
+                                     else if (Utils::ConsumeWord(parent, "protected"))
+                                     {
+                                         type = InheritanceType::Protected;
+                                     }
+                                     else
+                                     {
+                                         Utils::ConsumeWord(parent, "private");
+                                     }
+
+                                     details.parents.emplace_back(type, Symbol(Utils::NormalizeLineBreaks(parent)));
+                                 });
         }
 
         return true;
@@ -129,17 +400,18 @@ namespace Ast::Cpp
             return false;
         }
 
-        const auto* openedBracket = _token.endData - 1; // -1 - to back to the '{' correspoinding to regex expr
+        const auto* openedBracket = GetTokenReader().endData - 1; // -1 - to back to the '{' correspoinding to regex expr
         if (!Verify(*openedBracket == '{', "Impossible to define an class scope."))
         {
             logCollector.AddLog({ String::Format("Impossible to define an class scope '{}'", _lexerName.c_str()), LogCollector::LogType::Error });
             return false;
         }
 
-        const auto* closedBracket = Utils::FindClosedBracket(openedBracket, '}', '{');
+        const auto* closedBracket = Utils::FindClosedBracket(*GetReader(), openedBracket, '}', '{');
 
-        _openScope = { openedBracket, String::GetLinesCountInText(_reader->Data(), openedBracket) };
-        _closeScope = { closedBracket, String::GetLinesCountInText(_reader->Data(), closedBracket) };
+        const auto& data = GetReader()->Data();
+        _openScope = { openedBracket, String::GetLinesCountInText(data, openedBracket) };
+        _closeScope = { closedBracket, String::GetLinesCountInText(data, closedBracket) };
 
         return true;
     }
@@ -154,16 +426,23 @@ namespace Ast::Cpp
         const auto* begin = Ast::Cpp::TryToFindTemplateBegin(this);
         if (begin == nullptr)
         {
-            begin = _token.beginData;
+            begin = GetTokenReader().beginData;
         }
         if (!Verify(begin))
         {
             return false;
         }
 
+        // a declaration at the very beginning of the content has no marker before it
+        const auto* contentBegin = GetReader()->Data().c_str();
+        if (begin == contentBegin)
+        {
+            return true;
+        }
+
         --begin;
 
-        while (String::IsSpace(*begin))
+        while (begin != contentBegin && String::IsSpace(*begin))
         {
             --begin;
         }
@@ -171,32 +450,35 @@ namespace Ast::Cpp
         // Corresponding to AstCpp/Markers.h -> #define CLASS
         if ((begin = Ast::Utils::SkipBracketsR(this, begin, '(', ')')))
         {
-            while (String::IsSpace(*begin))
+            while (begin != contentBegin && String::IsSpace(*begin))
             {
                 --begin;
             }
             const auto marker = "CLASS"_atom;
             begin -= marker.Size();
-            if (begin >= _reader->Data().c_str())
+            if (begin >= GetReader()->Data().c_str())
             {
-                if (String(begin, marker.Size()).RegexMatch(marker))
+                if (StringView(begin, marker.Size()) == marker.ToStringView())
                 {
-                    Marker marker;
-
+                    const auto* ruleBegin = begin;
                     while (*begin != '(')
                     {
-                        marker.rule.push_back(*begin);
                         ++begin;
                     }
 
-                    const auto* end = Utils::FindClosedBracket(begin, ')', '(');
-                    for (auto param : String(begin, end - begin).Split(","))
+                    Marker marker;
+                    marker.rule = String(ruleBegin, begin - ruleBegin);
+
+                    if (const auto* end = Utils::FindClosedBracket(begin, ')', '('); Verify(end))
                     {
-                        param.Trim(' ').Trim('(').Trim(')');
-                        marker.params.push_back(std::move(param));
+                        Utils::SplitTopLevel(StringView(begin + 1, end - begin - 1), ',',
+                                             [&marker](StringView param)
+                                             {
+                                                 marker.params.emplace_back(param.data(), param.size());
+                                             });
                     }
 
-                    _marking = std::move(marker);
+                    SetMark(std::move(marker));
                 }
             }
         }
@@ -204,172 +486,94 @@ namespace Ast::Cpp
         return true;
     }
 
-    bool ClassLexer::DoPostValidate(LogCollector& logCollector)
+    void ClassLexer::DoAnalyzeDetails(LogCollector& logCollector)
     {
-        if (!BaseLexer::DoPostValidate(logCollector))
-        {
-            return false;
-        }
-
         TryToFindTemplate(logCollector);
+        RecognizeFields();
+    }
 
-        RecognizeFields(logCollector);
+    void ClassLexer::DoReserveDetails()
+    {
+        [[maybe_unused]] auto& details = GetColdData<Details>();
+    }
 
-        return true;
+    const std::vector<ClassLexer::Field>& ClassLexer::GetFields() const
+    {
+        EnsureDetails();
+        return GetDetails().fields;
     }
 
-    void ClassLexer::TryToFindTemplate(LogCollector& logCollector)
+    bool ClassLexer::IsTemplate() const
     {
-        auto* begin = _token.beginData;
+        EnsureDetails();
+        return _isTemplate;
+    }
 
-        if (auto string = Cpp::TryToExtrudeTemplate(this))
-        {
-            _isTemplate = true;
+    void ClassLexer::CollectMemoryUsage(MemoryUsageInfo& usage) const
+    {
+        BaseLexer::CollectMemoryUsage(usage);
 
-            string.Trim('<').Trim('>');
-            int bracketsCount = 0;
-            String tmp;
-            for (int i = 0; i < string.Size(); ++i)
-            {
-                if (string[i] == '<')
-                {
-                    ++bracketsCount;
-                }
-                else if (string[i] == '>')
-                {
-                    --bracketsCount;
-                }
-                tmp.PushBack(string[i]);
+        usage.lexers += sizeof(ClassLexer) - sizeof(BaseLexer);
 
-                if (bracketsCount == 0)
-                {
-                    if (string[i] == ',')
-                    {
-                        tmp.Trim(',').Trim(' ');
-                        _templateUnits.push_back({ std::move(tmp) });
-                    }
-                }
-            }
-            _templateUnits.push_back({ std::move(tmp) });
+        const auto& details = GetDetails();
+        usage.details += MemoryUsageInfo::GetHeapSize(details.templateUnits) + MemoryUsageInfo::GetHeapSize(details.parents) +
+                         MemoryUsageInfo::GetHeapSize(details.fields);
+
+        for (auto&& unit : details.templateUnits)
+        {
+            usage.strings += MemoryUsageInfo::GetHeapSize(unit.expression);
         }
     }
 
-    void ClassLexer::RecognizeFields(LogCollector& logCollector)
+    const ClassLexer::Details& ClassLexer::GetDetails() const noexcept
     {
-        String body(_openScope->string, _closeScope->string - _openScope->string);
-        body.Trim('{').Trim('}');
-
-        RemoveNestedScopes(body);
-
-        const auto publics = body.FindRegex(R"(^\s*public\s*\:)");
-        const auto protecteds = body.FindRegex(R"(^\s*protected\s*\:)");
-        const auto privates = body.FindRegex(R"(^\s*private\s*\:)");
-
-        body.IterateRegex(R"(^\s*((static\s+)|(constexpr\s+)|(const\s+)|(constinit\s+))*[\w:]+(\<.*\>)?\s+\w+(((\s*=).*)|(;)))",
-                          [&](const String::StdRegexMatchResults& field)
-                          {
-                              auto str = String(field.str());
-                              str.RegexReplace(R"([\s;]*$)", "");
-                              str.RegexReplace(R"(^\s*)", "");
-
-                              Field tempField;
-
-                              if (auto match = str.FindRegex(R"(static\s+)"); !match.empty())
-                              {
-                                  tempField.isStatic = true;
-                                  str.RegexReplace(R"(static\s+)", "", std::regex_constants::match_flag_type::format_first_only);
-                              }
-                              if (auto match = str.FindRegex(R"(const\s+)"); !match.empty())
-                              {
-                                  tempField.isConst = true;
-                                  str.RegexReplace(R"(const\s+)", "", std::regex_constants::match_flag_type::format_first_only);
-                              }
-                              if (auto match = str.FindRegex(R"(constexpr\s+)"); !match.empty())
-                              {
-                                  tempField.isConstexpr = true;
-                                  str.RegexReplace(R"(constexpr\s+)", "", std::regex_constants::match_flag_type::format_first_only);
-                              }
-                              if (auto match = str.FindRegex(R"(constinit\s+)"); !match.empty())
-                              {
-                                  tempField.isConstinit = true;
-                                  str.RegexReplace(R"(constinit\s+)", "", std::regex_constants::match_flag_type::format_first_only);
-                              }
-
-                              if (auto matchType = str.FindRegex(R"(^[\w:]+(\<.*\>)?)"); Verify(!matchType.empty()))
-                              {
-                                  tempField.type = matchType.str();
-                                  tempField.type.ShrinkToFit();
-                                  str.RegexReplace(R"(^[\w:]+(\<.*\>)?)", "");
-                                  str.TrimStart(' ');
-                              }
-                              else
-                              {
-                                  logCollector.AddLog({ String::Format("Impossible to define a class's field type. Class: '{}'", _lexerName.c_str()),
-                                                        LogCollector::LogType::Error });
-                                  return true;
-                              }
-
-                              if (auto matchName = str.FindRegex(R"(^\w+)"); Verify(!matchName.empty()))
-                              {
-                                  tempField.name = matchName.str();
-                                  tempField.name.ShrinkToFit();
-                                  str.RegexReplace(R"(^\w+)", "");
-                                  str.TrimStart(' ');
-                              }
-                              else
-                              {
-                                  logCollector.AddLog({ String::Format("Impossible to define a class's field name. Class: '{}'", _lexerName.c_str()),
-                                                        LogCollector::LogType::Error });
-                                  return true;
-                              }
-
-                              long long minDistance = std::numeric_limits<long long>::max();
-                              AccessSpecifier accessSpecifier = AccessSpecifier::Private;
-                              for (auto&& token : publics)
-                              {
-                                  const auto distance = std::distance(token.first, field.begin()->first);
-                                  if (distance >= 0 && distance < minDistance)
-                                  {
-                                      minDistance = distance;
-                                      accessSpecifier = AccessSpecifier::Public;
-                                  }
-                              }
-                              for (auto&& token : protecteds)
-                              {
-                                  const auto distance = std::distance(token.first, field.begin()->first);
-                                  if (distance >= 0 && distance < minDistance)
-                                  {
-                                      minDistance = distance;
-                                      accessSpecifier = AccessSpecifier::Protected;
-                                  }
-                              }
-                              for (auto&& token : privates)
-                              {
-                                  const auto distance = std::distance(token.first, field.begin()->first);
-                                  if (distance >= 0 && distance < minDistance)
-                                  {
-                                      minDistance = distance;
-                                      accessSpecifier = AccessSpecifier::Private;
-                                  }
-                              }
-                              tempField.accessSpecifier = accessSpecifier;
-
-                              _fields.push_back(std::move(tempField));
-
-                              return true;
-                          });
+        static const Details emptyDetails;
+
+        const auto* details = FindColdData<Details>();
+        return details ? *details : emptyDetails;
     }
 
-    void ClassLexer::RemoveNestedScopes(String& body)
+    void ClassLexer::TryToFindTemplate(LogCollector& logCollector)
     {
-        const String::CharT* opened = nullptr;
-        while ((opened = Utils::FindFirstBracket(body.c_str(), '{')))
+        // e.g: '<class T, class U = std::vector<T>>'
+        auto view = Cpp::TryToExtrudeTemplate(this);
+        if (view.empty())
         {
-            if (const auto* closed = Utils::FindClosedBracket(opened, '}', '{'))
-            {
-                body.Erase(opened - body.c_str(), closed - body.c_str());
-            }
+            return;
+        }
+
+        _isTemplate = true;
+
+        if (view.starts_with('<') && view.ends_with('>'))
+        {
+            view = view.substr(1, view.size() - 2);
+        }
+
+        auto& templateUnits = GetColdData<Details>().templateUnits;
+        Utils::SplitTopLevel(view, ',',
+                             [&templateUnits](StringView unit)
+                             {
+                                 templateUnits.push_back({ String(Utils::NormalizeLineBreaks(unit)) });
+                             });
+    }
+
+    void ClassLexer::RecognizeFields()
+    {
+        // an unbalanced scope has no end, so there is no body to scan
+        if (!_openScope.string || !_closeScope.string)
+        {
+            return;
         }
+
+        // between the brackets of the class scope
+        const StringView body(_openScope.string + 1, _closeScope.string - _openScope.string - 1);
+
+        FieldScanner(body, *GetReader())
+            .Scan(
+                [this](Field&& field)
+                {
+                    GetColdData<Details>().fields.push_back(std::move(field));
+                });
     }
 
 } // namespace Ast::Cpp
\ No newline at end of file
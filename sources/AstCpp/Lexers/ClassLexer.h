@@ -50,7 +50,7 @@ namespace Ast::Cpp
         struct ParentUnit
         {
             InheritanceType type = InheritanceType::Private;
-            String name;
+            Symbol name;
         };
 
         enum class AccessSpecifier
@@ -66,47 +66,56 @@ namespace Ast::Cpp
             bool isConstexpr = false;
             bool isConstinit = false;
             bool isStatic = false;
-            String name;
-            String type;
+            Symbol name;
+            Symbol type;
             AccessSpecifier accessSpecifier = AccessSpecifier::Private;
         };
 
+        /// @brief cold part of the lexer, it's stored in the side tables
+        struct Details
+        {
+            std::vector<TemplateUnit> templateUnits;
+            std::vector<ParentUnit> parents;
+            std::vector<Field> fields;
+        };
+
     public:
         inline static const auto typeName = "class"_atom;
 
         ~ClassLexer() override = default;
 
-        [[nodiscard]] static Ptr Create(const ContentStream::Ptr& fileReader)
+        [[nodiscard]] static Ptr Create(const ContentStream::Ptr& fileReader, const LexerSideTables::Ptr& sideTables = nullptr)
         {
-            return { new ClassLexer(fileReader) };
+            return { new ClassLexer(fileReader, sideTables) };
         }
 
-        [[nodiscard]] const std::vector<ParentUnit>& GetClassParents() const noexcept { return _parents; }
-        [[nodiscard]] bool HasClassParents() const noexcept { return _parents.size(); }
-        [[nodiscard]] const std::vector<Field>& GetFields() const noexcept { return _fields; }
-        [[nodiscard]] bool HasFields() const noexcept { return _fields.size(); }
+        [[nodiscard]] const std::vector<ParentUnit>& GetClassParents() const noexcept { return GetDetails().parents; }
+        [[nodiscard]] bool HasClassParents() const noexcept { return GetDetails().parents.size(); }
+        [[nodiscard]] const std::vector<Field>& GetFields() const;
+        [[nodiscard]] bool HasFields() const { return GetFields().size(); }
         [[nodiscard]] bool IsFinal() const noexcept { return _hasFinal; }
-        [[nodiscard]] bool IsTemplate() const noexcept { return _isTemplate; }
+        [[nodiscard]] bool IsTemplate() const;
+
+        void CollectMemoryUsage(MemoryUsageInfo& usage) const override;
 
     protected:
-        explicit ClassLexer(const ContentStream::Ptr& fileReader);
+        ClassLexer(const ContentStream::Ptr& fileReader, const LexerSideTables::Ptr& sideTables);
 
         bool DoValidate(LogCollector& logCollector) override;
         bool DoValidateScope(LogCollector& logCollector) override;
         bool DoMarkingValidate(LogCollector& logCollector) override;
-        bool DoPostValidate(LogCollector& logCollector) override;
+        void DoAnalyzeDetails(LogCollector& logCollector) override;
+        void DoReserveDetails() override;
 
     private:
+        [[nodiscard]] const Details& GetDetails() const noexcept;
+
         void TryToFindTemplate(LogCollector& logCollector);
-        void RecognizeFields(LogCollector& logCollector);
-        void RemoveNestedScopes(String& body);
+        void RecognizeFields();
 
     private:
         bool _hasFinal = false;
         bool _isTemplate = false;
-        std::vector<TemplateUnit> _templateUnits;
-        std::vector<ParentUnit> _parents;
-        std::vector<Field> _fields;
     };
 
 } // namespace Ast::Cpp
\ No newline at end of file
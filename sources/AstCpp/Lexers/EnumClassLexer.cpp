@@ -21,49 +21,54 @@
 #include "EnumClassLexer.h"
 
 #include "Ast/LogCollector.h"
+#include "Ast/MemoryUsage.h"
 #include "Ast/Readers/ContentStream.h"
 #include "Ast/Utils/Scopes.h"
+#include "Ast/Utils/String.h"
 
 namespace Ast::Cpp
 {
 
-    EnumClassLexer::EnumClassLexer(const ContentStream::Ptr& fileReader)
-        : BaseLexer(fileReader, typeName)
+    EnumClassLexer::EnumClassLexer(const ContentStream::Ptr& fileReader, const LexerSideTables::Ptr& sideTables)
+        : BaseLexer(fileReader, sideTables, typeName)
     {
     }
 
     bool EnumClassLexer::DoValidate(LogCollector& logCollector)
     {
-        if (!Verify(_token.IsValid(), "Impossible to work with an invalid token"))
+        const auto& token = GetTokenReader();
+        if (!Verify(token.IsValid(), "Impossible to work with an invalid token"))
         {
             logCollector.AddLog({ "EnumClassLexer: Impossible to work with an invalid token", LogCollector::LogType::Error });
             return false;
         }
 
-        String string(_token.beginData, _token.endData - _token.beginData);
-        string.RegexReplace(R"(\n|\r|(enum class)|\{)", " ");
-        string.Trim(' ');
-        if (string.IsEmpty())
+        // e.g: 'enum class Name : long long'
+        StringView view(token.beginData, token.endData - token.beginData);
+        Utils::ConsumeWord(view, "enum");
+        Utils::ConsumeWord(view, "class");
+        if (view.empty())
         {
-            logCollector.AddLog({ String::Format("Impossible to parse enum class token at {}", _token.startLine), LogCollector::LogType::Error });
+            logCollector.AddLog({ String::Format("Impossible to parse enum class token at {}", token.startLine), LogCollector::LogType::Error });
             return false;
         }
 
-        auto match = string.FindRegex("^\\w+");
-        if (Verify(!match.empty(), "Impossible to define an enum class name"))
+        const auto name = Utils::ReadWord(view);
+        if (Verify(!name.empty(), "Impossible to define an enum class name"))
         {
-            _lexerName = match.str();
-            _lexerName.ShrinkToFit();
+            _lexerName = Symbol(name);
         }
         else
         {
-            logCollector.AddLog({ String::Format("Impossible to parse enum class token at {}", _token.startLine), LogCollector::LogType::Error });
+            logCollector.AddLog({ String::Format("Impossible to parse enum class token at {}", token.startLine), LogCollector::LogType::Error });
             return false;
         }
 
-        if (string.RegexReplace(R"(^\w+\s*:)", ""))
+        view = Utils::TrimView(view);
+        if (view.starts_with(':'))
         {
-            _type = string.Trim(' ');
+            view.remove_prefix(1);
+            GetColdData<Details>().type = Symbol(Utils::NormalizeLineBreaks(Utils::TrimView(view)));
         }
 
         return true;
@@ -76,10 +81,12 @@ namespace Ast::Cpp
             return false;
         }
 
-        const auto* openedBracket = _token.endData;
+        // comments between the header and the scope are masked or already removed
+        const auto reader = GetReader();
+        const auto* openedBracket = reader->SkipMasked(GetTokenReader().endData);
         while (String::Toolset::IsSpace(*openedBracket))
         {
-            ++openedBracket;
+            openedBracket = reader->SkipMasked(openedBracket + 1);
         }
         if (!Verify(*openedBracket == '{', "Impossible to define an enum class scope."))
         {
@@ -88,36 +95,90 @@ namespace Ast::Cpp
             return false;
         }
 
-        const auto* closedBracket = Utils::FindClosedBracket(openedBracket, '}', '{');
+        const auto* closedBracket = Utils::FindClosedBracket(*GetReader(), openedBracket, '}', '{');
 
-        _openScope = { openedBracket, String::GetLinesCountInText(_reader->Data(), openedBracket) };
-        _closeScope = { closedBracket, String::GetLinesCountInText(_reader->Data(), closedBracket) };
+        const auto& data = GetReader()->Data();
+        _openScope = { openedBracket, String::GetLinesCountInText(data, openedBracket) };
+        _closeScope = { closedBracket, String::GetLinesCountInText(data, closedBracket) };
 
-        if (!RecognizeConstants(logCollector))
+        return true;
+    }
+
+    void EnumClassLexer::DoAnalyzeDetails(LogCollector& logCollector)
+    {
+        RecognizeConstants(logCollector);
+    }
+
+    void EnumClassLexer::DoReserveDetails()
+    {
+        [[maybe_unused]] auto& details = GetColdData<Details>();
+    }
+
+    const std::vector<EnumClassLexer::Constant>& EnumClassLexer::GetConstants() const
+    {
+        EnsureDetails();
+        return GetDetails().constants;
+    }
+
+    void EnumClassLexer::CollectMemoryUsage(MemoryUsageInfo& usage) const
+    {
+        BaseLexer::CollectMemoryUsage(usage);
+
+        usage.lexers += sizeof(EnumClassLexer) - sizeof(BaseLexer);
+
+        const auto& details = GetDetails();
+        usage.details += MemoryUsageInfo::GetHeapSize(details.constants);
+        for (auto&& constant : details.constants)
         {
-            return false;
+            usage.strings += MemoryUsageInfo::GetHeapSize(constant.name);
         }
+    }
 
-        return true;
+    const EnumClassLexer::Details& EnumClassLexer::GetDetails() const noexcept
+    {
+        static const Details emptyDetails;
+
+        const auto* details = FindColdData<Details>();
+        return details ? *details : emptyDetails;
     }
 
     bool EnumClassLexer::RecognizeConstants(LogCollector& logCollector)
     {
-        if (!Verify(_openScope.has_value() && _openScope->IsValid() && _closeScope.has_value() && _closeScope->IsValid()))
+        if (!Verify(_openScope.IsValid() && _closeScope.IsValid()))
         {
             logCollector.AddLog({ String::Format("Impossible to get an enum class scope '{}'", _lexerName.c_str()), LogCollector::LogType::Error });
             return false;
         }
 
-        String buffer(_openScope->string, _closeScope->string - _openScope->string);
-        buffer.Trim('{').Trim('}').RegexReplace(R"(\s*)", "");
-        for (auto& constant : buffer.Split(","_atom))
+        auto& constants = GetColdData<Details>().constants;
+        const auto reader = GetReader();
+
+        // a constant is the leading word of every part between commas, e.g: '{ A = 1, B, C = A | B }'. Masked ranges are skipped
+        bool isNameExpected = true;
+        for (const auto* current = reader->SkipMasked(_openScope.string + 1); current < _closeScope.string;
+             current = reader->SkipMasked(current))
         {
-            if (auto match = constant.FindRegex(R"(^\w+)"); !match.empty())
+            if (*current == ',')
+            {
+                isNameExpected = true;
+            }
+            else if (isNameExpected && Utils::IsWordChar(*current))
             {
-                _constants.emplace_back(String(match.str()), std::nullopt);
-                _constants.back().name.ShrinkToFit();
+                StringView rest(current, _closeScope.string - current);
+                const auto name = Utils::ReadWord(rest);
+                constants.emplace_back(String(name.data(), name.size()), std::nullopt);
+                constants.back().name.ShrinkToFit();
+
+                isNameExpected = false;
+                current = rest.data();
+                continue;
             }
+            else if (!String::IsSpace(*current))
+            {
+                isNameExpected = false;
+            }
+
+            ++current;
         }
 
         return true;
@@ -40,31 +40,40 @@ namespace Ast::Cpp
             std::optional<unsigned long long> value;
         };
 
+        /// @brief cold part of the lexer, it's stored in the side tables
+        struct Details
+        {
+            Symbol type{ "int"_atom };
+            std::vector<Constant> constants;
+        };
+
     public:
         inline static const auto typeName = "enum class"_atom;
 
-        [[nodiscard]] static Ptr Create(const ContentStream::Ptr& fileReader)
+        [[nodiscard]] static Ptr Create(const ContentStream::Ptr& fileReader, const LexerSideTables::Ptr& sideTables = nullptr)
         {
-            return { new EnumClassLexer(fileReader) };
+            return { new EnumClassLexer(fileReader, sideTables) };
         }
 
         ~EnumClassLexer() override = default;
 
-        [[nodiscard]] const String& GetType() const noexcept { return _type; }
-        [[nodiscard]] const std::vector<Constant>& GetConstants() const noexcept { return _constants; }
+        [[nodiscard]] const String& GetType() const noexcept { return GetDetails().type.GetString(); }
+        [[nodiscard]] const std::vector<Constant>& GetConstants() const;
+
+        void CollectMemoryUsage(MemoryUsageInfo& usage) const override;
 
     protected:
-        explicit EnumClassLexer(const ContentStream::Ptr& fileReader);
+        EnumClassLexer(const ContentStream::Ptr& fileReader, const LexerSideTables::Ptr& sideTables);
 
         bool DoValidate(LogCollector& logCollector) override;
         bool DoValidateScope(LogCollector& logCollector) override;
+        void DoAnalyzeDetails(LogCollector& logCollector) override;
+        void DoReserveDetails() override;
 
     private:
-        bool RecognizeConstants(LogCollector& logCollector);
+        [[nodiscard]] const Details& GetDetails() const noexcept;
 
-    private:
-        String _type = "int"_atom;
-        std::vector<Constant> _constants;
+        bool RecognizeConstants(LogCollector& logCollector);
     };
 
 } // namespace Ast::Cpp
\ No newline at end of file
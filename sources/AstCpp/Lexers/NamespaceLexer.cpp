@@ -21,44 +21,70 @@
 #include "NamespaceLexer.h"
 
 #include "Ast/LogCollector.h"
+#include "Ast/MemoryUsage.h"
 #include "Ast/Readers/ContentStream.h"
 #include "Ast/Utils/Scopes.h"
+#include "Ast/Utils/String.h"
 
 namespace Ast::Cpp
 {
 
-    NamespaceLexer::NamespaceLexer(const ContentStream::Ptr& fileReader)
-        : BaseLexer(fileReader, typeName)
+    NamespaceLexer::NamespaceLexer(const ContentStream::Ptr& fileReader, const LexerSideTables::Ptr& sideTables)
+        : BaseLexer(fileReader, sideTables, typeName)
     {
     }
 
+    const std::vector<Symbol>& NamespaceLexer::GetNameList() const noexcept
+    {
+        static const std::vector<Symbol> emptyNameList;
+
+        const auto* details = FindColdData<Details>();
+        return details ? details->nameList : emptyNameList;
+    }
+
     bool NamespaceLexer::DoValidate(LogCollector& logCollector)
     {
-        if (!Verify(_token.IsValid(), "Impossible to work with an invalid token"))
+        const auto& token = GetTokenReader();
+        if (!Verify(token.IsValid(), "Impossible to work with an invalid token"))
         {
             logCollector.AddLog({ "NamespaceLexer: Impossible to work with an invalid token", LogCollector::LogType::Error });
             return false;
         }
 
-        String string(_token.beginData, _token.endData - _token.beginData);
-        string.RegexReplace(R"(\n|\r|(namespace))", " ");
-        string.Trim(' ');
-        if (string.IsEmpty())
+        // e.g: 'namespace A::B'
+        StringView view(token.beginData, token.endData - token.beginData);
+        Utils::ConsumeWord(view, "namespace");
+        if (view.empty())
         {
-            logCollector.AddLog({ String::Format("Impossible to parse namespace token at {}", _token.startLine), LogCollector::LogType::Error });
+            logCollector.AddLog({ String::Format("Impossible to parse namespace token at {}", token.startLine), LogCollector::LogType::Error });
             return false;
         }
 
-        _lexerName = string; // absolute name
+        _lexerName = Symbol(Utils::NormalizeLineBreaks(view)); // absolute name
 
-        for (auto&& name : string.Split("::"_atom))
+        auto& nameList = GetColdData<Details>().nameList;
+        for (auto separator = view.find("::"); !view.empty(); separator = view.find("::"))
         {
-            _nameList.push_back(std::move(name));
+            if (const auto name = Utils::TrimView(view.substr(0, separator)); !name.empty())
+            {
+                nameList.emplace_back(name);
+            }
+            view.remove_prefix(separator == StringView::npos ? view.size() : separator + 2);
         }
 
         return true;
     }
 
+    void NamespaceLexer::CollectMemoryUsage(MemoryUsageInfo& usage) const
+    {
+        BaseLexer::CollectMemoryUsage(usage);
+
+        usage.lexers += sizeof(NamespaceLexer) - sizeof(BaseLexer);
+
+        const auto& nameList = GetNameList();
+        usage.details += MemoryUsageInfo::GetHeapSize(nameList);
+    }
+
     bool NamespaceLexer::DoValidateScope(LogCollector& logCollector)
     {
         if (!BaseLexer::DoValidateScope(logCollector))
@@ -66,10 +92,12 @@ namespace Ast::Cpp
             return false;
         }
 
-        const auto* openedBracket = _token.endData;
+        // comments between the header and the scope are masked or already removed
+        const auto reader = GetReader();
+        const auto* openedBracket = reader->SkipMasked(GetTokenReader().endData);
         while (String::Toolset::IsSpace(*openedBracket))
         {
-            ++openedBracket;
+            openedBracket = reader->SkipMasked(openedBracket + 1);
         }
         if (!Verify(*openedBracket == '{', "Impossible to define a namespace scope."))
         {
@@ -77,10 +105,11 @@ namespace Ast::Cpp
             return false;
         }
 
-        const auto* closedBracket = Utils::FindClosedBracket(openedBracket, '}', '{');
+        const auto* closedBracket = Utils::FindClosedBracket(*GetReader(), openedBracket, '}', '{');
 
-        _openScope = { openedBracket, String::GetLinesCountInText(_reader->Data(), openedBracket) };
-        _closeScope = { closedBracket, String::GetLinesCountInText(_reader->Data(), closedBracket) };
+        const auto& data = GetReader()->Data();
+        _openScope = { openedBracket, String::GetLinesCountInText(data, openedBracket) };
+        _closeScope = { closedBracket, String::GetLinesCountInText(data, closedBracket) };
 
         return true;
     }
@@ -36,23 +36,28 @@ namespace Ast::Cpp
 
         inline static const auto typeName = "namespace"_atom;
 
-        [[nodiscard]] static Ptr Create(const ContentStream::Ptr& fileReader)
+        /// @brief cold part of the lexer, it's stored in the side tables
+        struct Details
         {
-            return { new NamespaceLexer(fileReader) };
+            std::vector<Symbol> nameList; // e.g: namespace A::B -> { "A", "B" }
+        };
+
+        [[nodiscard]] static Ptr Create(const ContentStream::Ptr& fileReader, const LexerSideTables::Ptr& sideTables = nullptr)
+        {
+            return { new NamespaceLexer(fileReader, sideTables) };
         }
 
         ~NamespaceLexer() override = default;
 
-        [[nodiscard]] const std::vector<String>& GetNameList() { return _nameList; }
+        [[nodiscard]] const std::vector<Symbol>& GetNameList() const noexcept;
+
+        void CollectMemoryUsage(MemoryUsageInfo& usage) const override;
 
     protected:
-        explicit NamespaceLexer(const ContentStream::Ptr& fileReader);
+        NamespaceLexer(const ContentStream::Ptr& fileReader, const LexerSideTables::Ptr& sideTables);
 
         bool DoValidate(LogCollector& logCollector) override;
         bool DoValidateScope(LogCollector& logCollector) override;
-
-    private:
-        std::vector<String> _nameList; // e.g: namespace A::B -> { "A", "B" }
     };
 
 } // namespace Ast::Cpp
\ No newline at end of file
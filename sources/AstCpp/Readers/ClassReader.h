@@ -20,6 +20,7 @@
 
 #pragma once
 
+#include "Ast/Readers/AnchoredRegexTokenReaderImpl.h"
 #include "Ast/Readers/BaseTokenReader.h"
 #include "Ast/Readers/RegexTokenReaderImpl.h"
 
@@ -37,6 +38,12 @@ namespace Ast::Cpp
         {
         }
 
+        /// @brief reads only the declarations starting at the anchors
+        ClassReader(const ContentStream::Ptr& reader, AnchoredRegexTokenReaderImpl::Anchors anchors)
+            : BaseTokenReader(reader, new AnchoredRegexTokenReaderImpl(this, regex, std::move(anchors)))
+        {
+        }
+
         ~ClassReader() override = default;
     };
 
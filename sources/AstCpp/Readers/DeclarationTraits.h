@@ -0,0 +1,64 @@
+// Copyright (c) 2024 Valerii Koniushenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "AstCpp/Lexers/ClassLexer.h"
+#include "AstCpp/Lexers/EnumClassLexer.h"
+#include "AstCpp/Lexers/NamespaceLexer.h"
+#include "ClassReader.h"
+#include "EnumClassReader.h"
+#include "NamespaceReader.h"
+
+namespace Ast::Cpp
+{
+
+    /**
+     * @brief Describes how the declarations of a lexer type are found: its reader, the first word of the reader's regex and
+     * its marker macro (see AstCpp/Markers.h). Specialize it to parse a custom lexer with FileParserT
+     */
+    template<IsLexer Lexer>
+    struct DeclarationTraits;
+
+    template<>
+    struct DeclarationTraits<ClassLexer> final
+    {
+        using Reader = ClassReader;
+        static constexpr StringView keyword = "class";
+        static constexpr StringView marker = "CLASS";
+    };
+
+    template<>
+    struct DeclarationTraits<EnumClassLexer> final
+    {
+        using Reader = EnumClassReader;
+        static constexpr StringView keyword = "enum";
+        static constexpr StringView marker = "ENUM_CLASS";
+    };
+
+    template<>
+    struct DeclarationTraits<NamespaceLexer> final
+    {
+        using Reader = NamespaceReader;
+        static constexpr StringView keyword = "namespace";
+        static constexpr StringView marker = "NAMESPACE";
+    };
+
+} // namespace Ast::Cpp
\ No newline at end of file
@@ -20,6 +20,7 @@
 
 #pragma once
 
+#include "Ast/Readers/AnchoredRegexTokenReaderImpl.h"
 #include "Ast/Readers/BaseTokenReader.h"
 #include "Ast/Readers/RegexTokenReaderImpl.h"
 
@@ -35,6 +36,12 @@ namespace Ast::Cpp
             : BaseTokenReader(fileReader, new RegexTokenReaderImpl(this, regex))
         {
         }
+
+        /// @brief reads only the declarations starting at the anchors
+        EnumClassReader(const ContentStream::Ptr& fileReader, AnchoredRegexTokenReaderImpl::Anchors anchors)
+            : BaseTokenReader(fileReader, new AnchoredRegexTokenReaderImpl(this, regex, std::move(anchors)))
+        {
+        }
         ~EnumClassReader() override = default;
     };
 
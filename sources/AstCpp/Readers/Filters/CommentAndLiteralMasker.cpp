@@ -0,0 +1,159 @@
+// Copyright (c) 2024 Valerii Koniushenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "CommentAndLiteralMasker.h"
+
+#include "Ast/Utils/String.h"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+
+namespace Ast::Cpp
+{
+
+    namespace
+    {
+        // every function takes the position of the opening characters and returns the position after the masked range
+
+        Size SkipLineComment(StringView content, Size position)
+        {
+            // a backslash before the line end continues the comment
+            for (position += 2; position < content.size(); ++position)
+            {
+                if (content[position] == '\n' && content[position - 1] != '\\')
+                {
+                    break;
+                }
+            }
+            return position;
+        }
+
+        Size SkipBlockComment(StringView content, Size position)
+        {
+            const auto end = content.find("*/", position + 2);
+            return end == StringView::npos ? content.size() : end + 2;
+        }
+
+        Size SkipQuoted(StringView content, Size position)
+        {
+            const auto quote = content[position];
+            for (++position; position < content.size(); ++position)
+            {
+                const auto ch = content[position];
+                if (ch == '\\')
+                {
+                    ++position;
+                }
+                else if (ch == quote)
+                {
+                    return position + 1;
+                }
+                else if (ch == '\n')
+                {
+                    // an unterminated literal ends with its line
+                    return position;
+                }
+            }
+            return content.size();
+        }
+
+        /// @brief R"delimiter( ... )delimiter", 'position' points to the quote
+        Size SkipRawString(StringView content, Size position)
+        {
+            const auto bracket = content.find('(', position);
+            if (bracket == StringView::npos)
+            {
+                return SkipQuoted(content, position);
+            }
+
+            String terminator(")");
+            terminator += String(content.data() + position + 1, bracket - position - 1);
+            terminator += '"';
+
+            const auto end = content.find(terminator.ToStringView(), bracket);
+            return end == StringView::npos ? content.size() : end + terminator.Size();
+        }
+
+        /// @brief the word which ends right before 'position'
+        StringView GetWordBefore(StringView content, Size position)
+        {
+            auto begin = position;
+            while (begin > 0 && Utils::IsWordChar(content[begin - 1]))
+            {
+                --begin;
+            }
+            return content.substr(begin, position - begin);
+        }
+    } // namespace
+
+    void CommentAndLiteralMasker::MakeMask(const String& content, ContentMask& mask)
+    {
+        constexpr std::array<StringView, 5> rawStringPrefixes = { "R", "LR", "uR", "UR", "u8R" };
+
+        const StringView data(content.c_str(), content.Size());
+        for (Size position = 0; position < data.size();)
+        {
+            const auto ch = data[position];
+            const auto next = position + 1 < data.size() ? data[position + 1] : '\0';
+
+            auto end = position;
+            if (ch == '/' && next == '/')
+            {
+                end = SkipLineComment(data, position);
+            }
+            else if (ch == '/' && next == '*')
+            {
+                end = SkipBlockComment(data, position);
+            }
+            else if (ch == '"')
+            {
+                const auto prefix = GetWordBefore(data, position);
+                if (std::ranges::find(rawStringPrefixes, prefix) != rawStringPrefixes.end())
+                {
+                    end = SkipRawString(data, position);
+                }
+                else
+                {
+                    end = SkipQuoted(data, position);
+                }
+            }
+            else if (ch == '\'')
+            {
+                // a quote inside of a number is a digit separator, e.g: 1'000'000
+                const auto prefix = GetWordBefore(data, position);
+                if (prefix.empty() || !std::isdigit(static_cast<unsigned char>(prefix.front())))
+                {
+                    end = SkipQuoted(data, position);
+                }
+            }
+
+            if (end == position)
+            {
+                ++position;
+                continue;
+            }
+
+            mask.Add(position, end);
+            position = end;
+        }
+    }
+
+} // namespace Ast::Cpp
\ No newline at end of file
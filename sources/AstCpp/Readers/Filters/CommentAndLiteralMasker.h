@@ -0,0 +1,39 @@
+// Copyright (c) 2024 Valerii Koniushenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "Ast/Readers/ContentStream.h"
+
+namespace Ast::Cpp
+{
+
+    /**
+     * @brief Masks comments, string and character literals (raw strings included) in one pass without changing the content
+     * @details Unlike CommentFilter the content isn't copied or rewritten, so offsets and lines stay exact. A line comment
+     * is masked up to its line break, so statements which end at the line end still end there.
+     */
+    class CommentAndLiteralMasker : public Ast::ContentMasker
+    {
+    public:
+        void MakeMask(const String& content, ContentMask& mask) override;
+    };
+
+} // namespace Ast::Cpp
\ No newline at end of file
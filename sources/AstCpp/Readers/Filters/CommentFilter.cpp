@@ -20,46 +20,196 @@
 
 #include "CommentFilter.h"
 
+#include "Ast/Utils/String.h"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+
 namespace Ast::Cpp
 {
 
-    void CommentFilter::MakeTransform(String& content)
+    namespace
     {
-        RemoveSingleLineComments(content);
-        RemoveMultiLineComments(content);
+        constexpr std::array<StringView, 5> rawStringPrefixes = { "R", "LR", "uR", "UR", "u8R" };
+        constexpr Size maxRawStringDelimiter = 16;
 
-        /*std::ofstream file("file.cpp");
-        file << content.c_str();
-        file.close();*/
-    }
+        [[nodiscard]] bool IsRawStringPrefix(const String& word)
+        {
+            return std::ranges::find(rawStringPrefixes, word.ToStringView()) != rawStringPrefixes.end();
+        }
 
-    void CommentFilter::RemoveSingleLineComments(String& content)
-    {
-        // removing '//' comments
-        static auto* const regexExpr = R"((?:\/\/(?:\\\n|[^\n])*\n))";
-        content.RegexReplace(regexExpr, "\n");
-    }
+        [[nodiscard]] bool IsRawStringDelimiterChar(String::CharT ch)
+        {
+            return ch != ' ' && ch != '(' && ch != ')' && ch != '\\' && !std::iscntrl(static_cast<unsigned char>(ch));
+        }
+    } // namespace
 
-    void CommentFilter::RemoveMultiLineComments(String& content)
+    void CommentFilter::Process(StringView chunk, Buffer& output)
     {
-        std::size_t offset = 0;
-
-        while (const auto* begin = content.Find("/*"))
+        for (const auto ch : chunk)
         {
-            const auto* end = content.Find("*/");
-
-            String endLines = "";
-            for (const auto* i = begin; *i && i != end; ++i)
+            switch (_state)
             {
-                if (*i == '\n')
+            case State::Code:
+                if (_hasPendingSlash)
+                {
+                    _hasPendingSlash = false;
+                    if (ch == '/' || ch == '*')
+                    {
+                        _state = ch == '/' ? State::LineComment : State::BlockComment;
+                        _previous = 0;
+                        continue;
+                    }
+                    output += '/';
+                }
+
+                if (ch == '/')
+                {
+                    _hasPendingSlash = true;
+                }
+                else
+                {
+                    // a quote inside of a number is a digit separator (1'000), after any other word it follows a prefix (L'', u8"")
+                    if (ch == '"' && IsRawStringPrefix(_word))
+                    {
+                        _state = State::RawStringDelimiter;
+                        _rawTerminator = ")";
+                    }
+                    else if (ch == '"' || (ch == '\'' && !_isNumber))
+                    {
+                        _state = State::Literal;
+                        _quote = ch;
+                    }
+                    output += ch;
+                }
+                TrackWord(ch);
+                break;
+
+            case State::LineComment:
+                // a backslash before the line end continues the comment
+                if (ch == '\n')
+                {
+                    output += '\n';
+                    if (_previous != '\\')
+                    {
+                        _state = State::Code;
+                    }
+                }
+                else if (ch == '\r' && _previous == '\\')
+                {
+                    // keep the backslash as the previous character for CRLF line ends
+                    continue;
+                }
+                break;
+
+            case State::BlockComment:
+                if (ch == '\n')
+                {
+                    output += '\n';
+                }
+                else if (ch == '/' && _previous == '*')
+                {
+                    _state = State::Code;
+                    _previous = 0;
+                    continue;
+                }
+                break;
+
+            case State::Literal:
+                output += ch;
+                if ((ch == _quote && _previous != '\\') || ch == '\n')
+                {
+                    _state = State::Code;
+                    _previous = 0;
+                    continue;
+                }
+                if (ch == '\\' && _previous == '\\')
                 {
-                    endLines += '\n';
+                    // an escaped backslash doesn't escape the next character
+                    _previous = 0;
+                    continue;
                 }
+                break;
+
+            case State::RawStringDelimiter:
+                output += ch;
+                if (ch == '(')
+                {
+                    _rawTerminator += '"';
+                    _rawMatched = 0;
+                    _state = State::RawString;
+                }
+                else if (IsRawStringDelimiterChar(ch) && ch != '"' && _rawTerminator.Size() <= maxRawStringDelimiter)
+                {
+                    _rawTerminator += ch;
+                }
+                else
+                {
+                    // not a raw string, the rest is read as an ordinary literal which ends with its line
+                    _state = ch == '"' || ch == '\n' ? State::Code : State::Literal;
+                    _quote = '"';
+                }
+                break;
+
+            case State::RawString:
+                // nothing is escaped in a raw string, it ends only with the terminator, the delimiter can't contain ')'
+                output += ch;
+                if (ch == _rawTerminator.ToStringView()[_rawMatched])
+                {
+                    ++_rawMatched;
+                }
+                else
+                {
+                    _rawMatched = ch == ')' ? 1 : 0;
+                }
+
+                if (_rawMatched == _rawTerminator.Size())
+                {
+                    _state = State::Code;
+                    _previous = 0;
+                    continue;
+                }
+                break;
             }
 
-            static auto* const regexExpr = R"((?:\/\*[\s\S]*?\*\/))";
-            content.RegexReplace(regexExpr, endLines, std::regex_constants::match_flag_type::format_first_only);
-            offset = end - content.c_str();
+            _previous = ch;
+        }
+    }
+
+    void CommentFilter::Finish(Buffer& output)
+    {
+        if (_hasPendingSlash)
+        {
+            output += '/';
+        }
+
+        _state = State::Code;
+        _previous = 0;
+        _hasPendingSlash = false;
+        _word = {};
+        _isNumber = false;
+        _rawTerminator = {};
+        _rawMatched = 0;
+    }
+
+    void CommentFilter::TrackWord(String::CharT ch)
+    {
+        if (!Utils::IsWordChar(ch))
+        {
+            _word = {};
+            _isNumber = false;
+            return;
+        }
+
+        if (_word.IsEmpty())
+        {
+            _isNumber = std::isdigit(static_cast<unsigned char>(ch));
+        }
+        // one more character than the longest prefix, so a longer word never matches it
+        if (_word.Size() <= rawStringPrefixes.back().size())
+        {
+            _word += ch;
         }
     }
 
@@ -25,14 +25,43 @@
 namespace Ast::Cpp
 {
 
-    class CommentFilter : public Ast::ContentFilter
+    /**
+     * @brief Removes line and block comments keeping the line breaks inside of them, so lines of the code stay the same
+     * @details Works in a single forward pass and can be fused with other streaming filters. Comment markers inside of
+     * string, raw string and character literals are kept.
+     */
+    class CommentFilter : public Ast::StreamingContentFilter
     {
     public:
-        void MakeTransform(String& content) override;
+        void Process(StringView chunk, Buffer& output) override;
+        void Finish(Buffer& output) override;
 
     private:
-        void RemoveSingleLineComments(String& content);
-        void RemoveMultiLineComments(String& content);
+        enum class State
+        {
+            Code,
+            LineComment,
+            BlockComment,
+            Literal,
+            RawStringDelimiter, // between R" and (
+            RawString
+        };
+
+    private:
+        /// @brief remembers the beginning of the word around the character in the code, the word may span chunks
+        void TrackWord(String::CharT ch);
+
+    private:
+        State _state = State::Code;
+        String::CharT _quote = 0;
+        String::CharT _previous = 0; // the previous character of the content, it may belong to the previous chunk
+        bool _hasPendingSlash = false; // '/' at the end of a chunk which may start a comment
+
+        String _word;           // the first characters of the current word of the code, enough to tell a literal prefix
+        bool _isNumber = false; // the current word starts with a digit, so a quote in it is a digit separator (1'000)
+
+        String _rawTerminator; // )delimiter" of the current raw string
+        Size _rawMatched = 0;  // characters of the terminator matched so far
     };
 
 } // namespace Ast::Cpp
\ No newline at end of file
@@ -0,0 +1,220 @@
+// Copyright (c) 2024 Valerii Koniushenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "KeywordPrefilter.h"
+
+#include "Ast/Utils/String.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+
+#if defined(_M_X64) || defined(__x86_64__)
+    #define AST_KEYWORDS_X86_64
+    #include <immintrin.h>
+    #if defined(_MSC_VER)
+        #include <intrin.h>
+        #define AST_KEYWORDS_AVX2
+    #else
+        #define AST_KEYWORDS_AVX2 __attribute__((target("avx2")))
+    #endif
+#endif
+
+namespace Ast::Cpp
+{
+
+    namespace
+    {
+        struct Keyword final
+        {
+            StringView word;
+            KeywordPrefilter::Anchors* anchors = nullptr;
+        };
+
+        using Keywords = std::vector<Keyword>;
+
+        // the readers' regexes start from '^\s*keyword', so only whole words preceded by whitespaces in their line are accepted
+        bool IsCandidate(StringView content, const ContentMask& mask, Size position, const Keyword& keyword)
+        {
+            const auto end = position + keyword.word.size();
+            if (end > content.size() || (end < content.size() && Utils::IsWordChar(content[end])))
+            {
+                return false;
+            }
+            if (content.compare(position, keyword.word.size(), keyword.word) != 0 || mask.IsMasked(position))
+            {
+                return false;
+            }
+
+            // masked ranges before the keyword are treated as whitespaces
+            for (auto i = position; i > 0; --i)
+            {
+                if (content[i - 1] == '\n')
+                {
+                    return true;
+                }
+                if (String::IsSpace(content[i - 1]))
+                {
+                    continue;
+                }
+                if (const auto* range = mask.Find(i - 1))
+                {
+                    i = range->begin + 1;
+                    continue;
+                }
+                return false;
+            }
+
+            return true;
+        }
+
+        void TryToAdd(StringView content, const ContentMask& mask, Size position, const Keyword& keyword)
+        {
+            if (IsCandidate(content, mask, position, keyword))
+            {
+                keyword.anchors->push_back(content.data() + position);
+            }
+        }
+
+        // finishes the content from 'position' when it's too short for the vector loads
+        void ScanScalar(StringView content, const ContentMask& mask, Size position, const Keywords& keywords)
+        {
+            for (auto&& keyword : keywords)
+            {
+                for (auto i = content.find(keyword.word, position); i != StringView::npos; i = content.find(keyword.word, i + 1))
+                {
+                    TryToAdd(content, mask, i, keyword);
+                }
+            }
+        }
+
+#ifdef AST_KEYWORDS_X86_64
+        // a candidate has to match both the first and the last characters of a keyword, the rest is compared by IsCandidate
+
+        Size ScanSse2(StringView content, const ContentMask& mask, const Keywords& keywords, Size maxKeywordSize)
+        {
+            constexpr Size width = sizeof(__m128i);
+            const auto* data = content.data();
+
+            Size position = 0;
+            for (; position + width + maxKeywordSize <= content.size(); position += width)
+            {
+                const auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + position));
+                for (auto&& keyword : keywords)
+                {
+                    const auto last = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + position + keyword.word.size() - 1));
+                    const auto matched = _mm_and_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8(keyword.word.front())),
+                                                       _mm_cmpeq_epi8(last, _mm_set1_epi8(keyword.word.back())));
+                    for (auto bits = static_cast<std::uint32_t>(_mm_movemask_epi8(matched)); bits != 0; bits &= bits - 1)
+                    {
+                        TryToAdd(content, mask, position + std::countr_zero(bits), keyword);
+                    }
+                }
+            }
+
+            return position;
+        }
+
+        AST_KEYWORDS_AVX2 Size ScanAvx2(StringView content, const ContentMask& mask, const Keywords& keywords, Size maxKeywordSize)
+        {
+            constexpr Size width = sizeof(__m256i);
+            const auto* data = content.data();
+
+            Size position = 0;
+            for (; position + width + maxKeywordSize <= content.size(); position += width)
+            {
+                const auto block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + position));
+                for (auto&& keyword : keywords)
+                {
+                    const auto last = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + position + keyword.word.size() - 1));
+                    const auto matched = _mm256_and_si256(_mm256_cmpeq_epi8(block, _mm256_set1_epi8(keyword.word.front())),
+                                                          _mm256_cmpeq_epi8(last, _mm256_set1_epi8(keyword.word.back())));
+                    for (auto bits = static_cast<std::uint32_t>(_mm256_movemask_epi8(matched)); bits != 0; bits &= bits - 1)
+                    {
+                        TryToAdd(content, mask, position + std::countr_zero(bits), keyword);
+                    }
+                }
+            }
+
+            return position;
+        }
+
+        bool IsAvx2Supported()
+        {
+    #if defined(_MSC_VER)
+            int info[4];
+            __cpuid(info, 0);
+            if (info[0] < 7)
+            {
+                return false;
+            }
+
+            // the OS has to save the YMM registers
+            __cpuid(info, 1);
+            if ((info[2] & (1 << 27)) == 0 || (_xgetbv(0) & 0x6) != 0x6)
+            {
+                return false;
+            }
+
+            __cpuidex(info, 7, 0);
+            return (info[1] & (1 << 5)) != 0;
+    #else
+            return __builtin_cpu_supports("avx2");
+    #endif
+        }
+#endif
+    } // namespace
+
+    KeywordPrefilter::KeywordPrefilter(const String& data, std::span<const StringView> words, const ContentMask& mask)
+        : _anchors(words.size())
+    {
+        Keywords keywords;
+        for (Size i = 0; i < words.size(); ++i)
+        {
+            if (Verify(!words[i].empty(), "Impossible to search an empty keyword"))
+            {
+                keywords.push_back({ words[i], &_anchors[i] });
+            }
+        }
+
+        if (keywords.empty())
+        {
+            return;
+        }
+
+        const StringView content(data.c_str(), data.Size());
+
+        Size position = 0;
+#ifdef AST_KEYWORDS_X86_64
+        const Size maxKeywordSize = std::ranges::max(keywords, {}, [](const Keyword& keyword) { return keyword.word.size(); }).word.size();
+
+        static const bool isAvx2Supported = IsAvx2Supported();
+        position = isAvx2Supported ? ScanAvx2(content, mask, keywords, maxKeywordSize) : ScanSse2(content, mask, keywords, maxKeywordSize);
+#endif
+        ScanScalar(content, mask, position, keywords);
+    }
+
+    bool KeywordPrefilter::IsEmpty() const noexcept
+    {
+        return std::ranges::all_of(_anchors, [](const Anchors& anchors) { return anchors.empty(); });
+    }
+
+} // namespace Ast::Cpp
\ No newline at end of file
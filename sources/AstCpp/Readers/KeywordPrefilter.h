@@ -0,0 +1,55 @@
+// Copyright (c) 2024 Valerii Koniushenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "Ast/Readers/AnchoredRegexTokenReaderImpl.h"
+#include "Ast/Readers/ContentMask.h"
+
+#include <span>
+
+namespace Ast::Cpp
+{
+
+    /**
+     * @brief Finds the candidates for the declarations (e.g: 'class', 'enum', 'namespace' at the beginning of a line) in one pass
+     * @details Uses AVX2 or SSE2 when the CPU supports them and a scalar search otherwise. The readers then match their regexes
+     * only at the candidates, and a content without any candidate isn't read at all. A candidate has the same restrictions
+     * as the beginnings of the readers' regexes ('^\s*class'), so the found declarations are the same as without the filter.
+     */
+    class KeywordPrefilter final
+    {
+    public:
+        using Anchors = AnchoredRegexTokenReaderImpl::Anchors;
+
+    public:
+        /// @brief keywords inside of the masked ranges aren't candidates
+        KeywordPrefilter(const String& data, std::span<const StringView> keywords, const ContentMask& mask = {});
+
+        /// @brief candidates for the keyword by its index, sorted by their positions
+        [[nodiscard]] const Anchors& GetDeclarations(Size keywordIndex) const { return _anchors[keywordIndex]; }
+
+        [[nodiscard]] bool IsEmpty() const noexcept;
+
+    private:
+        std::vector<Anchors> _anchors;
+    };
+
+} // namespace Ast::Cpp
\ No newline at end of file
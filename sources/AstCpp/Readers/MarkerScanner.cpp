@@ -0,0 +1,109 @@
+// Copyright (c) 2024 Valerii Koniushenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "MarkerScanner.h"
+
+#include "Ast/Utils/Scopes.h"
+#include "Ast/Utils/String.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace Ast::Cpp
+{
+
+    namespace
+    {
+        const String::CharT* SkipSpaces(const String::CharT* current, const String::CharT* end)
+        {
+            while (current < end && String::IsSpace(*current))
+            {
+                ++current;
+            }
+            return current;
+        }
+    } // namespace
+
+    MarkerScanner::MarkerScanner(const String& data, std::span<const StringView> markers, const ContentMask& mask)
+        : _anchors(markers.size())
+    {
+        auto nextMasked = mask.GetRanges().begin();
+        const auto* const end = data.c_str() + data.Size();
+        bool isLineBegin = true;
+        for (const auto* current = data.c_str(); current < end;)
+        {
+            if (nextMasked != mask.GetRanges().end() && current >= data.c_str() + nextMasked->begin)
+            {
+                current = std::max(current, data.c_str() + nextMasked->end);
+                ++nextMasked;
+                continue;
+            }
+
+            if (*current == '\n' || String::IsSpace(*current))
+            {
+                isLineBegin = isLineBegin || *current == '\n';
+                ++current;
+                continue;
+            }
+
+            if (std::exchange(isLineBegin, false) && *current == '#')
+            {
+                current = std::find(current, end, '\n');
+                continue;
+            }
+
+            if (!Utils::IsWordChar(*current))
+            {
+                ++current;
+                continue;
+            }
+
+            StringView rest(current, end - current);
+            const auto word = Utils::ReadWord(rest);
+            current = SkipSpaces(rest.data(), end);
+
+            const auto marker = std::ranges::find(markers, word);
+            if (marker == markers.end() || current == end || *current != '(')
+            {
+                continue;
+            }
+
+            const auto* closedBracket = Utils::FindClosedBracket(current, ')', '(');
+            if (!closedBracket)
+            {
+                break;
+            }
+            current = SkipSpaces(closedBracket + 1, end);
+
+            auto* declaration = current;
+            rest = StringView(current, end - current);
+            if (Utils::ConsumeWord(rest, "template") && !rest.empty() && rest.front() == '<')
+            {
+                if (const auto* templateEnd = Utils::FindClosedBracket(rest.data(), '>', '<'))
+                {
+                    declaration = SkipSpaces(templateEnd + 1, end);
+                }
+            }
+
+            _anchors[marker - markers.begin()].push_back(declaration);
+        }
+    }
+
+} // namespace Ast::Cpp
\ No newline at end of file
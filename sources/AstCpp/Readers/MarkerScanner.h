@@ -0,0 +1,53 @@
+// Copyright (c) 2024 Valerii Koniushenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "Ast/Readers/AnchoredRegexTokenReaderImpl.h"
+#include "Ast/Readers/ContentMask.h"
+
+#include <span>
+
+namespace Ast::Cpp
+{
+
+    /**
+     * @brief Finds the marker macros (e.g: CLASS, ENUM_CLASS, NAMESPACE of AstCpp/Markers.h) in one pass over the content
+     * @details Remembers where the declarations following the markers start, so the readers match only them. Template heads
+     * are skipped, i.e. for 'CLASS() template<class T> class A' the declaration starts at 'class'. Preprocessor lines are
+     * ignored, so the definitions of the markers aren't treated as their invocations.
+     */
+    class MarkerScanner final
+    {
+    public:
+        using Anchors = AnchoredRegexTokenReaderImpl::Anchors;
+
+    public:
+        /// @brief markers inside of the masked ranges (e.g. commented out ones) are skipped
+        MarkerScanner(const String& data, std::span<const StringView> markers, const ContentMask& mask = {});
+
+        /// @brief starts of the declarations marked by the marker with the index, sorted by their positions
+        [[nodiscard]] const Anchors& GetDeclarations(Size markerIndex) const { return _anchors[markerIndex]; }
+
+    private:
+        std::vector<Anchors> _anchors;
+    };
+
+} // namespace Ast::Cpp
\ No newline at end of file
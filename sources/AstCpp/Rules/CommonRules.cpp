@@ -53,24 +53,35 @@ namespace Ast::Cpp
         return false;
     }
 
+    String LineCountRule::GetFingerprint() const
+    {
+        return String::Format("LineCountRule({}, {})", _max, static_cast<int>(GetLogType()));
+    }
+
     NameRule::NameRule(const String& regexNameRule)
     {
         SetRegexNameRule(regexNameRule);
     }
 
+    NameRule::NameRule(const Pattern& namePattern)
+        : _namePattern{ namePattern }
+    {
+        Verify(_namePattern.IsValid());
+    }
+
     void NameRule::SetRegexNameRule(const String& regexNameRule)
     {
         if (Verify(!regexNameRule.IsEmpty()))
         {
-            _regexNameRule = regexNameRule;
+            _namePattern = Pattern(regexNameRule);
         }
     }
 
     bool NameRule::IsCorrespondingTheRules(const BaseLexer* lexer, LogCollector& logCollector, const char* additionalMessage /* = nullptr*/) const
     {
-        if (const auto&& name = lexer->GetLexerName())
+        if (const auto& name = lexer->GetLexerName())
         {
-            if (name.RegexMatch(_regexNameRule.ToStringView()))
+            if (_namePattern.Match(name.ToStringView()))
             {
                 return true;
             }
@@ -82,4 +93,10 @@ namespace Ast::Cpp
         return false;
     }
 
-} // namespace Ast::Cpp
+    String NameRule::GetFingerprint() const
+    {
+        const auto expression = String(_namePattern.GetExpression().data(), _namePattern.GetExpression().size());
+        return String::Format("NameRule({}, {})", expression.CStr(), static_cast<int>(GetLogType()));
+    }
+
+} // namespace Ast::Cpp
\ No newline at end of file
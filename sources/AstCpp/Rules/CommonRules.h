@@ -20,6 +20,7 @@
 
 #pragma once
 
+#include "Ast/Pattern.h"
 #include "Ast/Rule.h"
 
 namespace Ast::Cpp
@@ -35,6 +36,7 @@ namespace Ast::Cpp
         [[nodiscard]] std::size_t GetMaxLineCount() const noexcept { return _max; }
         [[nodiscard]] bool IsCorrespondingTheRules(const BaseLexer* lexer, LogCollector& logCollector,
                                                    const char* additionalMessage = nullptr) const override;
+        [[nodiscard]] String GetFingerprint() const override;
 
     private:
         std::size_t _max = 0;
@@ -46,13 +48,17 @@ namespace Ast::Cpp
         AST_CLASS(NameRule)
 
         explicit NameRule(const String& regexNameRule);
+        /// @param namePattern an already compiled pattern, e.g. checked by Pattern::TryCompile()
+        explicit NameRule(const Pattern& namePattern);
 
         void SetRegexNameRule(const String& regexNameRule);
         [[nodiscard]] bool IsCorrespondingTheRules(const BaseLexer* lexer, LogCollector& logCollector,
                                                    const char* additionalMessage = nullptr) const override;
+        [[nodiscard]] String GetFingerprint() const override;
 
     private:
-        String _regexNameRule;
+        /// @brief compiled once when the rule is set, evaluation only matches it
+        Pattern _namePattern;
     };
 
 } // namespace Ast::Cpp
\ No newline at end of file
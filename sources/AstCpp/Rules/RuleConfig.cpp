@@ -0,0 +1,321 @@
+// Copyright (c) 2024 Valerii Koniushenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "RuleConfig.h"
+
+#include "AstCpp/Lexers/ClassLexer.h"
+#include "AstCpp/Lexers/EnumClassLexer.h"
+#include "AstCpp/Lexers/NamespaceLexer.h"
+#include "CommonRules.h"
+#include "Utils/Functions.h"
+
+#include <charconv>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace Ast::Cpp
+{
+
+    namespace
+    {
+        struct RuleLine final
+        {
+            Size number = 0;
+            std::vector<String> tokens;
+        };
+
+        /// @brief splits the line by whitespaces, double quotes group a value with spaces, '#' starts a comment
+        [[nodiscard]] bool SplitTokens(StringView line, std::vector<String>& tokens)
+        {
+            String token;
+            bool hasToken = false;
+            bool isInQuotes = false;
+            for (const auto ch : line)
+            {
+                if (isInQuotes)
+                {
+                    if (ch == '"')
+                    {
+                        isInQuotes = false;
+                    }
+                    else
+                    {
+                        token += ch;
+                    }
+                    continue;
+                }
+
+                if (ch == '#')
+                {
+                    break;
+                }
+                if (ch == '"')
+                {
+                    isInQuotes = true;
+                    hasToken = true;
+                }
+                else if (String::IsSpace(ch))
+                {
+                    if (hasToken)
+                    {
+                        tokens.push_back(std::exchange(token, String()));
+                        hasToken = false;
+                    }
+                }
+                else
+                {
+                    token += ch;
+                    hasToken = true;
+                }
+            }
+
+            if (hasToken)
+            {
+                tokens.push_back(std::move(token));
+            }
+            return !isInQuotes;
+        }
+
+        [[nodiscard]] std::optional<String> FindLexerType(const String& name)
+        {
+            if (name == "class")
+            {
+                return String(ClassLexer::typeName);
+            }
+            if (name == "enum-class")
+            {
+                return String(EnumClassLexer::typeName);
+            }
+            if (name == "namespace")
+            {
+                return String(NamespaceLexer::typeName);
+            }
+            return std::nullopt;
+        }
+
+        [[nodiscard]] std::optional<LogCollector::LogType> FindLogType(const String& name)
+        {
+            if (name == "info")
+            {
+                return LogCollector::LogType::Info;
+            }
+            if (name == "warning")
+            {
+                return LogCollector::LogType::Warning;
+            }
+            if (name == "error")
+            {
+                return LogCollector::LogType::Error;
+            }
+            if (name == "success")
+            {
+                return LogCollector::LogType::Success;
+            }
+            return std::nullopt;
+        }
+
+        class RuleConfigCompiler final
+        {
+        public:
+            explicit RuleConfigCompiler(LogCollector& logCollector)
+                : _logCollector{ logCollector }
+            {
+            }
+
+            void CompileLine(Size number, StringView text)
+            {
+                _line = number;
+                RuleLine line{ number, {} };
+                if (!SplitTokens(text, line.tokens))
+                {
+                    AddError("unclosed quotes");
+                    return;
+                }
+                if (line.tokens.empty())
+                {
+                    return;
+                }
+
+                if (line.tokens.size() < 2)
+                {
+                    AddError("expected a rule kind and a lexer type");
+                    return;
+                }
+
+                const auto& kind = line.tokens[0];
+                const auto lexerType = FindLexerType(line.tokens[1]);
+                if (!lexerType)
+                {
+                    AddError(String::Format("unknown lexer type '{}'", line.tokens[1].CStr()));
+                    return;
+                }
+
+                String pattern;
+                std::optional<std::size_t> max;
+                std::optional<LogCollector::LogType> logType;
+                String marker;
+                String message;
+                for (Size i = 2; i < line.tokens.size(); ++i)
+                {
+                    const auto param = line.tokens[i].ToStringView();
+                    const auto separator = param.find('=');
+                    if (separator == StringView::npos || separator == 0)
+                    {
+                        AddError(String::Format("expected 'key=value' but got '{}'", line.tokens[i].CStr()));
+                        return;
+                    }
+
+                    const auto key = String(param.data(), separator);
+                    const auto value = param.substr(separator + 1);
+                    const auto valueString = String(value.data(), value.size());
+                    if (key == "pattern" && kind == "name")
+                    {
+                        pattern = valueString;
+                    }
+                    else if (key == "max" && kind == "line-count")
+                    {
+                        std::size_t number = 0;
+                        const auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), number);
+                        if (error != std::errc() || end != value.data() + value.size())
+                        {
+                            AddError(String::Format("'{}' isn't a line count", valueString.CStr()));
+                            return;
+                        }
+                        max = number;
+                    }
+                    else if (key == "severity")
+                    {
+                        if (!(logType = FindLogType(valueString)))
+                        {
+                            AddError(String::Format("unknown severity '{}'", valueString.CStr()));
+                            return;
+                        }
+                    }
+                    else if (key == "marker")
+                    {
+                        marker = valueString;
+                    }
+                    else if (key == "message")
+                    {
+                        message = valueString;
+                    }
+                    else
+                    {
+                        AddError(String::Format("unknown parameter '{}' of the rule '{}'", key.CStr(), kind.CStr()));
+                        return;
+                    }
+                }
+
+                Rule::Ptr rule;
+                if (kind == "name")
+                {
+                    // compiled once: the same pattern is checked here and given to the rule
+                    const auto namePattern = Pattern::TryCompile(pattern.ToStringView());
+                    if (pattern.IsEmpty() || !namePattern.IsValid())
+                    {
+                        AddError("the rule 'name' requires a valid 'pattern'");
+                        return;
+                    }
+                    NameRule::Ptr nameRule = new NameRule(namePattern);
+                    if (logType)
+                    {
+                        nameRule->OverrideLogType(*logType);
+                    }
+                    rule = nameRule;
+                }
+                else if (kind == "line-count")
+                {
+                    if (!max)
+                    {
+                        AddError("the rule 'line-count' requires 'max'");
+                        return;
+                    }
+                    LineCountRule::Ptr lineCountRule = new LineCountRule(*max);
+                    if (logType)
+                    {
+                        lineCountRule->OverrideLogType(*logType);
+                    }
+                    rule = lineCountRule;
+                }
+                else
+                {
+                    AddError(String::Format("unknown rule kind '{}'", kind.CStr()));
+                    return;
+                }
+
+                _ruleSet.Add(*lexerType, rule, message, marker);
+            }
+
+            [[nodiscard]] bool HasErrors() const noexcept { return _hasErrors; }
+            [[nodiscard]] RuleSet& GetRuleSet() noexcept { return _ruleSet; }
+
+        private:
+            void AddError(const String& message)
+            {
+                _hasErrors = true;
+                _logCollector.AddLog({ String::Format("RuleConfig: line {}: {}", _line, message.CStr()), LogCollector::LogType::Error });
+            }
+
+        private:
+            LogCollector& _logCollector;
+            RuleSet _ruleSet;
+            Size _line = 0;
+            bool _hasErrors = false;
+        };
+    } // namespace
+
+    bool CompileRuleConfig(StringView config, RuleSet& ruleSet, LogCollector& logCollector)
+    {
+        RuleConfigCompiler compiler(logCollector);
+
+        Size lineNumber = 0;
+        while (!config.empty())
+        {
+            ++lineNumber;
+            const auto lineEnd = config.find('\n');
+            const auto line = config.substr(0, lineEnd);
+            config.remove_prefix(lineEnd == StringView::npos ? config.size() : lineEnd + 1);
+
+            compiler.CompileLine(lineNumber, line);
+        }
+
+        if (compiler.HasErrors())
+        {
+            return false;
+        }
+
+        ruleSet = std::move(compiler.GetRuleSet());
+        return true;
+    }
+
+    bool LoadRuleConfig(const std::filesystem::path& path, RuleSet& ruleSet, LogCollector& logCollector)
+    {
+        const auto config = ::Utils::GetTextFileContentAs<String>(path);
+        if (config.IsEmpty())
+        {
+            logCollector.AddLog({ String::Format("RuleConfig: impossible to read '{}'", path.string().c_str()), LogCollector::LogType::Error });
+            return false;
+        }
+
+        return CompileRuleConfig(config.ToStringView(), ruleSet, logCollector);
+    }
+
+} // namespace Ast::Cpp
\ No newline at end of file
@@ -0,0 +1,48 @@
+// Copyright (c) 2024 Valerii Koniushenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "Ast/RuleSet.h"
+
+#include <filesystem>
+
+namespace Ast::Cpp
+{
+
+    /**
+     * @brief Compiles a rule configuration into a RuleSet
+     * @details The configuration has a rule per line: its kind, the lexer type it's applied to and 'key=value' parameters.
+     * Values with spaces are put into double quotes, '#' starts a comment.
+     * @code
+     * # kind      lexer       parameters
+     * name        class       pattern=[A-Z]\w* severity=warning
+     * line-count  class       max=300 marker=CLASS(Serializable) message="the serializable class is too long"
+     * @endcode
+     * Kinds: 'name' (pattern=), 'line-count' (max=). Lexer types: class, enum-class, namespace. Every rule accepts
+     * severity=info|warning|error|success, marker=<Param or MARK(Param), see RuleSet> and message=<additional message>.
+     * The whole configuration is validated first: on any error nothing is added to the rule set and the errors are
+     * reported with their line numbers.
+     */
+    [[nodiscard]] bool CompileRuleConfig(StringView config, RuleSet& ruleSet, LogCollector& logCollector);
+
+    [[nodiscard]] bool LoadRuleConfig(const std::filesystem::path& path, RuleSet& ruleSet, LogCollector& logCollector);
+
+} // namespace Ast::Cpp
\ No newline at end of file
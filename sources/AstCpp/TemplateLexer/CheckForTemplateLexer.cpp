@@ -22,41 +22,51 @@
 
 #include "Ast/Lexers/BaseLexer.h"
 #include "Ast/Utils/Scopes.h"
+#include "Ast/Utils/String.h"
 #include "Core/Assert.h"
 
 namespace
 {
-    std::optional<std::pair<const Ast::String::CharT*, Ast::String>> FindTemplate(const Ast::BaseLexer* lexer)
+    std::optional<std::pair<const Ast::String::CharT*, Ast::StringView>> FindTemplate(const Ast::BaseLexer* lexer)
     {
         if (!Verify(lexer))
         {
             return {};
         }
 
-        if (auto scope = lexer->GetTokenReader(); scope.beginData)
+        // nothing before a declaration at the very beginning of the content
+        const auto* contentBegin = lexer->GetReader()->Data().c_str();
+        if (auto scope = lexer->GetTokenReader(); scope.beginData && scope.beginData != contentBegin)
         {
             auto end = scope.beginData - 1;
-            while (Ast::String::Toolset::IsSpace(*end))
+            while (end != contentBegin && Ast::String::Toolset::IsSpace(*end))
             {
                 --end;
             }
+            if (Ast::String::Toolset::IsSpace(*end))
+            {
+                return {};
+            }
 
             if (auto* src = Ast::Utils::FindClosedBracketR(end, '>', '<'))
             {
-                while (Ast::String::IsSpace(*src) || *src == '<')
+                while (src > contentBegin && (Ast::String::IsSpace(*src) || *src == '<'))
                 {
                     --src;
                 }
-                while (!Ast::String::IsSpace(*src))
+                while (src > contentBegin && !Ast::String::IsSpace(*src))
                 {
                     --src;
                 }
-                ++src;
+                if (Ast::String::IsSpace(*src))
+                {
+                    ++src;
+                }
 
-                auto string = Ast::String(src, end - src + 1).Trim(' ');
-                if (string.RegexReplace(R"(^template[ ]*)", ""))
+                auto view = Ast::StringView(src, end - src + 1);
+                if (Ast::Utils::ConsumeWord(view, "template"))
                 {
-                    return { { src, string } };
+                    return { { src, view } };
                 }
             }
         }
@@ -76,7 +86,7 @@ namespace Ast::Cpp
         return nullptr;
     }
 
-    String TryToExtrudeTemplate(const BaseLexer* lexer)
+    StringView TryToExtrudeTemplate(const BaseLexer* lexer)
     {
         if (const auto temp = FindTemplate(lexer))
         {
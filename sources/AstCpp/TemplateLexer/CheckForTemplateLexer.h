@@ -30,7 +30,8 @@ namespace Ast::Cpp
 {
 
     const String::CharT* TryToFindTemplateBegin(const BaseLexer* lexer);
-    String TryToExtrudeTemplate(const BaseLexer* lexer);
+    /// @brief e.g: '<class T>' for 'template<class T> class A', the view points into the content of the lexer
+    StringView TryToExtrudeTemplate(const BaseLexer* lexer);
     bool IsTemplate(const BaseLexer* lexer);
 
 } // namespace Ast::Cpp
\ No newline at end of file
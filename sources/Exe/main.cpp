@@ -19,18 +19,121 @@
 // SOFTWARE.
 
 #include "Ast/ASTFileTree.h"
+#include "Ast/MemoryUsage.h"
 #include "Ast/Readers/FileReader.h"
+#include "Ast/RuleCache.h"
+#include "Ast/Symbol.h"
 #include "Ast/Utils/IO.h"
 #include "AstCpp/FileParser.h"
 #include "AstCpp/Readers/Filters/CommentFilter.h"
+#include "AstCpp/Rules/RuleConfig.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
 #include <iostream>
+#include <string_view>
+#include <vector>
 
-int main()
+namespace
 {
-    Ast::FileReader::Ptr fileReader = new Ast::FileReader;
+    [[nodiscard]] bool IsSourceFile(const std::filesystem::path& path)
+    {
+        static const char* const extensions[] = { ".h", ".hh", ".hpp", ".hxx", ".inl", ".c", ".cc", ".cpp", ".cxx" };
+
+        const auto extension = path.extension();
+        return std::find(std::begin(extensions), std::end(extensions), extension) != std::end(extensions);
+    }
+
+    [[nodiscard]] std::vector<std::filesystem::path> CollectProjectFiles(const std::filesystem::path& path)
+    {
+        std::vector<std::filesystem::path> files;
+        if (!std::filesystem::is_directory(path))
+        {
+            files.push_back(path);
+            return files;
+        }
+
+        for (auto&& entry : std::filesystem::recursive_directory_iterator(path))
+        {
+            if (entry.is_regular_file() && IsSourceFile(entry.path()))
+            {
+                files.push_back(entry.path());
+            }
+        }
+
+        return files;
+    }
+
+    void PrintMemoryReport(const Ast::MemoryUsageInfo& usage, std::size_t filesCount)
+    {
+        using namespace std;
+
+        cout << "ASTCpp: memory report for " << filesCount << " file(s)" << '\n';
+        cout << "\tcontent streams: " << usage.contentStream << " bytes" << '\n';
+        cout << "\tlexers:          " << usage.lexers << " bytes" << '\n';
+        cout << "\tstrings:         " << usage.strings << " bytes" << '\n';
+        cout << "\tlexer details:   " << usage.details << " bytes" << '\n';
+        cout << "\tchild pointers:  " << usage.childPointers << " bytes" << '\n';
+        cout << "\tlogs:            " << usage.logs << " bytes" << '\n';
+        cout << "\tnode table:      " << usage.nodeTable << " bytes" << '\n';
+        cout << "\ttotal:           " << usage.Total() << " bytes" << '\n';
+        cout << "\tinterned names:  " << Ast::Symbol::GetMemoryUsage() << " bytes, " << Ast::Symbol::GetSymbolsCount()
+             << " symbol(s) shared by all the files" << endl;
+    }
+} // namespace
+
+// Usage: ASTCpp [path to a file or a project directory] [--memory-report] [--aggregate-logs] [--rules=<path to a rule config>] [--rules-cache=<path>] [--time-budget=<ms per file>]
+int main(int argc, char** argv)
+{
+    static constexpr std::string_view memoryReportFlag = "--memory-report";
+    static constexpr std::string_view aggregateLogsFlag = "--aggregate-logs";
+    static constexpr std::string_view rulesFlag = "--rules=";
+    static constexpr std::string_view rulesCacheFlag = "--rules-cache=";
+    static constexpr std::string_view timeBudgetFlag = "--time-budget=";
+    static constexpr std::size_t logSamplesCount = 5;
+
+    std::filesystem::path path = "D:\\Workspace\\test.cpp";
+    bool isMemoryReport = false;
+    bool isAggregateLogs = false;
+    std::filesystem::path rulesPath;
+    std::filesystem::path rulesCachePath;
+    Ast::ParseOptions parseOptions;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::string_view(argv[i]) == memoryReportFlag)
+        {
+            isMemoryReport = true;
+        }
+        else if (std::string_view(argv[i]) == aggregateLogsFlag)
+        {
+            isAggregateLogs = true;
+        }
+        else if (std::string_view(argv[i]).starts_with(rulesFlag))
+        {
+            rulesPath = std::string_view(argv[i]).substr(rulesFlag.size());
+        }
+        else if (std::string_view(argv[i]).starts_with(rulesCacheFlag))
+        {
+            rulesCachePath = std::string_view(argv[i]).substr(rulesCacheFlag.size());
+        }
+        else if (std::string_view(argv[i]).starts_with(timeBudgetFlag))
+        {
+            parseOptions.timeBudget = std::chrono::milliseconds(std::atoll(argv[i] + timeBudgetFlag.size()));
+        }
+        else
+        {
+            path = argv[i];
+        }
+    }
+
     Ast::LogCollector logCollector;
-    logCollector.onValidationEvent.Subscribe(
+    if (isAggregateLogs)
+    {
+        logCollector.SetAggregation(logSamplesCount);
+    }
+    logCollector.Subscribe(
         [](const Ast::String& message, Ast::LogCollector::LogType logType)
         {
             using namespace std;
@@ -55,16 +158,70 @@ int main()
                 return "None";
             }();
 
-            cout << "ASTCpp: [" << typeStr << "]: " << message.CStr() << endl;
+            // called in batches by the dispatching thread, the stream is flushed once at the end
+            cout << "ASTCpp: [" << typeStr << "]: " << message.CStr() << '\n';
         });
 
-    if (fileReader->ReadFromFile("D:\\Workspace\\test.cpp"))
+    // the config is validated and compiled once, before any file is parsed
+    Ast::RuleSet ruleSet;
+    if (!rulesPath.empty() && !Ast::Cpp::LoadRuleConfig(rulesPath, ruleSet, logCollector))
+    {
+        return 1;
+    }
+
+    // the results of the previous run for the unchanged lexers, a missing cache is filled by this run
+    Ast::RuleCache ruleCache;
+    Ast::RuleCache* ruleCachePtr = rulesCachePath.empty() ? nullptr : &ruleCache;
+    if (ruleCachePtr)
+    {
+        ruleCache.Load(rulesCachePath);
+    }
+    logCollector.StartAsyncDispatch();
+
+    Ast::MemoryUsageInfo totalUsage;
+    std::size_t filesCount = 0;
+    for (auto&& file : CollectProjectFiles(path))
     {
+        Ast::FileReader::Ptr fileReader = new Ast::FileReader;
+        if (!fileReader->ReadFromFile(file))
+        {
+            continue;
+        }
+
         fileReader->ApplyFilters<Ast::Cpp::CommentFilter>();
         Ast::ASTFileTree tree(fileReader);
-        tree.ParseUsing<Ast::Cpp::FileParser>(logCollector);
+        // a file over the budget gives a partial tree and an error instead of stalling the whole run
+        tree.ParseUsing<Ast::Cpp::FileParser>(logCollector, parseOptions);
+        if (!ruleSet.IsEmpty())
+        {
+            ruleSet.Apply(tree, logCollector, ruleCachePtr);
+        }
+
+        if (isMemoryReport)
+        {
+            totalUsage += tree.MemoryUsage();
+            ++filesCount;
+        }
+        else
+        {
+            // the logs of the file go before its tree
+            logCollector.Flush();
+            std::cout << tree << '\n';
+        }
+    }
 
-        std::cout << tree << std::endl;
+    logCollector.StopAsyncDispatch();
+    logCollector.EmitSummary();
+
+    if (ruleCachePtr && !ruleCache.Save(rulesCachePath))
+    {
+        std::cout << "ASTCpp: [Warning]: impossible to save the rules cache to " << rulesCachePath << '\n';
+    }
+
+    if (isMemoryReport)
+    {
+        totalUsage.logs = logCollector.GetMemoryUsage();
+        PrintMemoryReport(totalUsage, filesCount);
     }
 
     return 0;
@@ -24,16 +24,27 @@
 #include "Ast/LogCollector.h"
 #include "Ast/Modifiers/BaseLexerModifier.h"
 #include "Ast/Modifiers/FileLexerModifier.h"
+#include "Ast/Pattern.h"
 #include "Ast/Readers/ContentStream.h"
+#include "Ast/RuleCache.h"
+#include "Ast/RuleSet.h"
 #include "AstCpp/FileParser.h"
+#include "AstCpp/Readers/Filters/CommentAndLiteralMasker.h"
 #include "AstCpp/Readers/Filters/CommentFilter.h"
+#include "AstCpp/Readers/KeywordPrefilter.h"
 #include "AstCpp/Rules/ClassRules.h"
 #include "AstCpp/Rules/CommonRules.h"
 #include "AstCpp/Rules/EnumClassRules.h"
 #include "AstCpp/Rules/NamespaceRules.h"
+#include "AstCpp/Rules/RuleConfig.h"
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <thread>
+
 namespace
 {
     const char* const content = R"(#pragma   once
@@ -434,11 +445,13 @@ TEST(ASTTests, ScopeChecking)
 
         lexer = found->CastTo<Ast::Cpp::ClassLexer>();
         ASSERT_TRUE(lexer);
+        ASSERT_TRUE(lexer->HasParent());
     }
 
+    // the tree is gone, so the lexer survives only as a standalone one
     ASSERT_TRUE(lexer);
     EXPECT_EQ(lexer->GetLexerName(), "Internal");
-    ASSERT_TRUE(lexer->HasParent());
+    EXPECT_FALSE(lexer->HasParent());
 }
 
 TEST(ASTTests, GetRootLexer)
@@ -815,4 +828,1392 @@ TEST(ASTTests, GenerateNewClass)
     myClass->TryToSetParent(myFile);
 
     EXPECT_EQ(myClass->GetParentLexer(), myFile);
+}
+
+TEST(ASTTests, MemoryUsage)
+{
+    Ast::LogCollector logCollector;
+    const auto tree = GetASTFileTree(logCollector);
+
+    const auto usage = tree.MemoryUsage(&logCollector);
+    EXPECT_GE(usage.contentStream, std::strlen(content));
+    EXPECT_GT(usage.lexers, 0);
+    EXPECT_GT(usage.details, 0);
+    EXPECT_GT(usage.childPointers, 0);
+    EXPECT_GT(usage.logs, 0);
+    EXPECT_GT(usage.nodeTable, 0);
+    EXPECT_EQ(usage.Total(),
+              usage.contentStream + usage.lexers + usage.strings + usage.details + usage.childPointers + usage.logs + usage.nodeTable);
+
+    const auto withoutLogs = tree.MemoryUsage();
+    EXPECT_EQ(0, withoutLogs.logs);
+    EXPECT_EQ(usage.lexers, withoutLogs.lexers);
+
+    // short strings are stored inline and have no heap payload
+    const Ast::String shortString("A");
+    const Ast::String longString("TheConstantWithTheNameLongerThanAnyInlineBuffer");
+    EXPECT_EQ(0, Ast::MemoryUsageInfo::GetHeapSize(shortString));
+    EXPECT_EQ((longString.Size() + 1) * sizeof(Ast::String::CharT), Ast::MemoryUsageInfo::GetHeapSize(longString));
+
+    auto reader = Ast::ContentStream::Create();
+    reader->Read("enum class E\n{\n    A,\n    TheConstantWithTheNameLongerThanAnyInlineBuffer\n};\n");
+    Ast::ASTFileTree enumTree(reader);
+    enumTree.ParseUsing<Ast::Cpp::FileParser>(logCollector);
+    EXPECT_EQ(Ast::MemoryUsageInfo::GetHeapSize(longString), enumTree.MemoryUsage().strings);
+}
+
+TEST(ASTTests, TreeIsReleased)
+{
+    // a copy would share the children, see ~BaseLexer()
+    static_assert(!std::is_copy_constructible_v<Ast::BaseLexer> && !std::is_copy_assignable_v<Ast::BaseLexer>);
+
+    for (int i = 0; i < 20; ++i)
+    {
+        Ast::BaseLexer::Ptr root;
+        Ast::BaseLexer::Ptr internal;
+
+        {
+            Ast::LogCollector logCollector;
+            auto tree = GetASTFileTree(logCollector);
+
+            internal = tree.FindFirstByName("Internal");
+            ASSERT_TRUE(internal);
+            root = internal->GetRootLexer();
+            ASSERT_TRUE(root);
+        }
+
+        // parent links don't own anything, so only our pointers are left
+        EXPECT_EQ(1, root->use_count());
+
+        root.reset();
+        EXPECT_FALSE(internal->HasParent());
+        EXPECT_EQ(1, internal->use_count());
+    }
+}
+
+TEST(ASTTests, TreeTeardown)
+{
+    Ast::LogCollector logCollector;
+    auto tree = GetASTFileTree(logCollector);
+
+    auto found = tree.FindFirstByName("GlobalClass");
+    ASSERT_TRUE(found);
+    ASSERT_TRUE(found->HasParent());
+    ASSERT_TRUE(found->HasChildLexers());
+
+    tree.Teardown();
+
+    EXPECT_FALSE(tree.GetReader());
+    EXPECT_FALSE(tree.FindFirstByName("GlobalClass"));
+    EXPECT_FALSE(found->HasParent());
+    EXPECT_FALSE(found->HasChildLexers());
+    EXPECT_EQ(1, found->use_count());
+}
+
+TEST(ASTTests, NodeTable)
+{
+    Ast::LogCollector logCollector;
+    const auto tree = GetASTFileTree(logCollector);
+
+    const auto pinnedTable = tree.GetNodeTable();
+    const auto& table = *pinnedTable;
+    ASSERT_FALSE(table.IsEmpty());
+    EXPECT_EQ(Ast::NodeTable::invalidNode, table.GetParent(0));
+    EXPECT_EQ(Ast::NodeTable::GetTypeTag(Ast::FileLexer::typeName), table.GetTypeTag(0));
+
+    for (Ast::NodeTable::NodeId node = 0; node < table.GetSize(); ++node)
+    {
+        const auto* lexer = table.GetLexer(node);
+        ASSERT_TRUE(lexer);
+        EXPECT_EQ(lexer->GetLexerName().ToStringView(), table.GetName(node));
+        EXPECT_EQ(Ast::NodeTable::GetTypeTag(lexer->GetLexerType()), table.GetTypeTag(node));
+
+        if (lexer->GetOpenScope() && lexer->GetCloseScope())
+        {
+            EXPECT_EQ(lexer->GetOpenScope()->line, table.GetOpenLine(node));
+            EXPECT_EQ(lexer->GetCloseScope()->line, table.GetCloseLine(node));
+            EXPECT_LT(table.GetOpenOffset(node), table.GetCloseOffset(node));
+        }
+
+        std::size_t childIndex = 0;
+        for (auto child = table.GetFirstChild(node); child != Ast::NodeTable::invalidNode; child = table.GetNextSibling(child))
+        {
+            ASSERT_LT(childIndex, lexer->GetChildLexers().size());
+            EXPECT_EQ(lexer->GetChildLexers()[childIndex].get(), table.GetLexer(child));
+            EXPECT_EQ(node, table.GetParent(child));
+            EXPECT_EQ(table.GetNesting(node) + 1, table.GetNesting(child));
+            ++childIndex;
+        }
+        EXPECT_EQ(lexer->GetChildLexers().size(), childIndex);
+    }
+}
+
+TEST(ASTTests, NodeTableFollowsTreeChanges)
+{
+    Ast::LogCollector logCollector;
+    auto tree = GetASTFileTree(logCollector);
+
+    const auto countLexers = [&tree]()
+    {
+        std::size_t count = 0;
+        std::as_const(tree).ForEach(
+            [&count](const Ast::BaseLexer*, Ast::ASTFileTree::Params)
+            {
+                ++count;
+                return true;
+            });
+        return count;
+    };
+    const auto lexersCount = countLexers();
+    ASSERT_EQ(lexersCount, tree.GetNodeTable()->GetSize());
+
+    // attached after the parsing
+    auto added = Ast::Cpp::ClassLexer::Create(tree.GetReader());
+    Ast::BaseLexerModifier(added).SetLexerName("AddedAfterParsing");
+    auto global = tree.FindFirstByName("GlobalClass");
+    ASSERT_TRUE(global);
+    global->ForceSetAsChild(added);
+
+    EXPECT_EQ(added, tree.FindFirstByName("AddedAfterParsing"));
+    EXPECT_EQ(added, tree.FindFirstByNameAs<Ast::Cpp::ClassLexer>("AddedAfterParsing"));
+    EXPECT_EQ(lexersCount + 1, countLexers());
+
+    // renamed by a modifier
+    auto internal = tree.FindFirstByName("Internal");
+    ASSERT_TRUE(internal);
+    Ast::BaseLexerModifier(internal).SetLexerName("RenamedInternal");
+    EXPECT_EQ(internal, tree.FindFirstByName("RenamedInternal"));
+    EXPECT_NE(internal, tree.FindFirstByName("Internal"));
+    EXPECT_EQ(internal, tree.FindIf([](const Ast::BaseLexer* lexer) { return lexer->GetLexerName() == "RenamedInternal"; }));
+
+    // detached
+    const auto detached = global->DetachChildLexers();
+    ASSERT_FALSE(detached.empty());
+    EXPECT_FALSE(tree.FindFirstByName("AddedAfterParsing"));
+    EXPECT_GT(lexersCount + 1, countLexers());
+    EXPECT_EQ(countLexers(), tree.GetNodeTable()->GetSize());
+}
+
+TEST(ASTTests, NodeTableNestedQueries)
+{
+    auto reader = Ast::ContentStream::Create();
+    reader->Read("class A\n{\n};\nclass B\n{\n};\nclass C\n{\n};\n");
+    Ast::LogCollector logCollector;
+    Ast::ASTFileTree tree(reader);
+    tree.ParseUsing<Ast::Cpp::FileParser>(logCollector);
+
+    const auto collectNames = [&tree](const std::function<void(const std::string&)>& onVisit = {})
+    {
+        std::vector<std::string> names;
+        tree.ForEach<Ast::Cpp::ClassLexer>(
+            [&](Ast::BaseLexer* lexer, Ast::ASTFileTree::Params)
+            {
+                names.emplace_back(lexer->GetLexerName().c_str());
+                if (onVisit)
+                {
+                    onVisit(names.back());
+                }
+                return true;
+            });
+        return names;
+    };
+
+    // the walk keeps its table while a nested query builds a new one for the changed tree
+    auto added = Ast::Cpp::ClassLexer::Create(reader);
+    Ast::BaseLexerModifier(added).SetLexerName("AddedDuringWalk");
+    const auto names = collectNames(
+        [&](const std::string& name)
+        {
+            if (name == "B")
+            {
+                auto a = tree.FindFirstByName("A");
+                ASSERT_TRUE(a);
+                a->ForceSetAsChild(added);
+                EXPECT_EQ(added, tree.FindFirstByName("AddedDuringWalk"));
+            }
+        });
+    EXPECT_EQ((std::vector<std::string>{ "A", "B", "C" }), names);
+    EXPECT_EQ((std::vector<std::string>{ "A", "AddedDuringWalk", "B", "C" }), collectNames());
+}
+
+TEST(ASTTests, LexerSideTables)
+{
+    Ast::LogCollector logCollector;
+    const auto tree = GetASTFileTree(logCollector);
+
+    const auto sideTables = tree.GetSideTables();
+    ASSERT_TRUE(sideTables);
+
+    std::vector<Ast::LexerSideTables::NodeId> nodeIds;
+    tree.ForEach(
+        [&](const Ast::BaseLexer* lexer, Ast::ASTFileTree::Params)
+        {
+            EXPECT_EQ(sideTables.get(), lexer->GetSideTables().get());
+            EXPECT_EQ(tree.GetReader().get(), lexer->GetReader().get());
+            EXPECT_LT(lexer->GetNodeId(), sideTables->GetNodesCount());
+            nodeIds.push_back(lexer->GetNodeId());
+            return true;
+        });
+    std::ranges::sort(nodeIds);
+    EXPECT_EQ(nodeIds.end(), std::ranges::adjacent_find(nodeIds));
+
+    const auto lexer = tree.FindFirstByNameAs<Ast::Cpp::ClassLexer>("Vec2");
+    ASSERT_TRUE(lexer);
+    EXPECT_TRUE(lexer->GetTokenReader().IsValid());
+    EXPECT_NE(nullptr, sideTables->Find<Ast::Cpp::ClassLexer::Details>(lexer->GetNodeId()));
+}
+
+TEST(ASTTests, Symbols)
+{
+    const Ast::Symbol a("std::string"_atom);
+    const Ast::Symbol b(Ast::String("std::string"));
+    const Ast::Symbol c("int"_atom);
+
+    EXPECT_EQ(a, b);
+    EXPECT_NE(a, c);
+    EXPECT_EQ(&a.GetString(), &b.GetString());
+    EXPECT_EQ("std::string", a);
+    EXPECT_TRUE(Ast::Symbol().IsEmpty());
+    EXPECT_EQ(a, Ast::Symbol::Find("std::string"));
+    EXPECT_TRUE(Ast::Symbol::Find("NeverInternedName_42").IsEmpty());
+
+    Ast::LogCollector logCollector;
+    const auto tree = GetASTFileTree(logCollector);
+    const auto found = tree.FindFirstByNameAs<Ast::Cpp::ClassLexer>("GlobalClass");
+    ASSERT_TRUE(found);
+    EXPECT_EQ(Ast::Symbol::Find("GlobalClass"), found->GetLexerNameSymbol());
+    EXPECT_FALSE(tree.FindFirstByName("NeverInternedName_42"));
+
+    // the same type name used by different fields is stored once
+    const Ast::Symbol* intType = nullptr;
+    for (auto&& field : found->GetFields())
+    {
+        if (field.type == "int")
+        {
+            if (intType)
+            {
+                EXPECT_EQ(*intType, field.type);
+            }
+            intType = &field.type;
+        }
+    }
+    EXPECT_TRUE(intType);
+}
+
+TEST(ASTTests, ClassFieldsScanner)
+{
+    Ast::LogCollector logCollector;
+    const auto tree = GetASTFileTree(logCollector);
+
+    const auto reader = tree.FindFirstByNameAs<Ast::Cpp::ClassLexer>("Reader");
+    ASSERT_TRUE(reader);
+
+    const auto& fields = reader->GetFields();
+    ASSERT_EQ(9, fields.size());
+
+    using Access = Ast::Cpp::ClassLexer::AccessSpecifier;
+    const auto expectField = [&fields](std::size_t i, const char* type, const char* name, Access access)
+    {
+        EXPECT_EQ(type, fields[i].type);
+        EXPECT_EQ(name, fields[i].name);
+        EXPECT_EQ(access, fields[i].accessSpecifier);
+    };
+
+    expectField(0, "int", "smthPrivate", Access::Private);
+    expectField(1, "int", "staticVar", Access::Public);
+    expectField(2, "int", "staticConstVar", Access::Public);
+    expectField(3, "int", "staticConstexprVar", Access::Public);
+    expectField(4, "int", "staticConstexprVar", Access::Public);
+    expectField(5, "int", "a", Access::Private);
+    expectField(6, "String", "_content_static", Access::Private);
+    expectField(7, "std::filesystem::path", "_path", Access::Private);
+    expectField(8, "std::vector<typename Toolset::Smth<int, std::is_same_v<int, double>>>", "_someVector", Access::Private);
+
+    EXPECT_TRUE(fields[1].isStatic);
+    EXPECT_FALSE(fields[1].isConst);
+    EXPECT_TRUE(fields[2].isStatic && fields[2].isConst);
+    EXPECT_TRUE(fields[3].isStatic && fields[3].isConstexpr);
+    EXPECT_TRUE(fields[4].isStatic && fields[4].isConstexpr);
+    EXPECT_FALSE(fields[4].isConst);
+}
+
+TEST(ASTTests, ClassFieldsAroundNestedScopes)
+{
+    auto reader = Ast::ContentStream::Create();
+    reader->Read(R"(
+class Widget
+{
+public:
+    int Width() const { int local = 0; return _width + local; }
+    void Resize(int width)
+    {
+        if (width > 0) { _width = width; }
+    }
+
+private:
+    int _width{ 10 };
+    std::vector<int> _items = { 1, 2, 3 };
+    bool _visible = true;
+};
+)");
+
+    Ast::LogCollector logCollector;
+    Ast::ASTFileTree tree(reader);
+    tree.ParseUsing<Ast::Cpp::FileParser>(logCollector);
+
+    const auto widget = tree.FindFirstByNameAs<Ast::Cpp::ClassLexer>("Widget");
+    ASSERT_TRUE(widget);
+
+    const auto& fields = widget->GetFields();
+    ASSERT_EQ(3, fields.size());
+    EXPECT_EQ("_width", fields[0].name);
+    EXPECT_EQ("_items", fields[1].name);
+    EXPECT_EQ("std::vector<int>", fields[1].type);
+    EXPECT_EQ("_visible", fields[2].name);
+    for (auto&& field : fields)
+    {
+        EXPECT_EQ(Ast::Cpp::ClassLexer::AccessSpecifier::Private, field.accessSpecifier);
+    }
+}
+
+TEST(ASTTests, LexerHeadersParsing)
+{
+    Ast::LogCollector logCollector;
+    auto tree = GetASTFileTree(logCollector);
+
+    const auto readerType = tree.FindFirstByNameAs<Ast::Cpp::EnumClassLexer>("ReaderType");
+    ASSERT_TRUE(readerType);
+    EXPECT_EQ("long long", readerType->GetType());
+
+    const auto eType = tree.FindFirstByNameAs<Ast::Cpp::EnumClassLexer>("EType");
+    ASSERT_TRUE(eType);
+    EXPECT_EQ("int", eType->GetType());
+
+    const auto utils = tree.FindFirstByNameAs<Ast::Cpp::NamespaceLexer>("Ast2::Utils");
+    ASSERT_TRUE(utils);
+    ASSERT_EQ(2, utils->GetNameList().size());
+    EXPECT_EQ("Ast2", utils->GetNameList()[0]);
+    EXPECT_EQ("Utils", utils->GetNameList()[1]);
+
+    const auto reader = tree.FindFirstByNameAs<Ast::Cpp::ClassLexer>("Reader");
+    ASSERT_TRUE(reader);
+    EXPECT_TRUE(reader->IsFinal());
+    ASSERT_EQ(1, reader->GetClassParents().size());
+    EXPECT_EQ("Utils::CopyableAndMoveable", reader->GetClassParents()[0].name);
+}
+
+TEST(ASTTests, LazyDetails)
+{
+    static_assert(!std::is_move_constructible_v<Ast::BaseLexer> && !std::is_move_assignable_v<Ast::BaseLexer>);
+
+    auto reader = Ast::ContentStream::Create();
+    reader->Read(content);
+    reader->ApplyFilters<Ast::Cpp::CommentFilter>();
+
+    Ast::LogCollector logCollector;
+    Ast::ASTFileTree tree(reader);
+    tree.ParseUsing<Ast::Cpp::FileParser>(logCollector, { .lazyDetails = true });
+
+    const auto eagerTree = GetASTFileTree(logCollector);
+
+    const auto lazyClass = tree.FindFirstByNameAs<Ast::Cpp::ClassLexer>("GlobalClass");
+    const auto eagerClass = eagerTree.FindFirstByNameAs<Ast::Cpp::ClassLexer>("GlobalClass");
+    ASSERT_TRUE(lazyClass);
+    ASSERT_TRUE(eagerClass);
+
+    // nothing is analyzed until the details are requested
+    const auto* details = tree.GetSideTables()->Find<Ast::Cpp::ClassLexer::Details>(lazyClass->GetNodeId());
+    ASSERT_TRUE(details);
+    EXPECT_TRUE(details->fields.empty());
+    EXPECT_EQ(eagerClass->GetClassParents().size(), lazyClass->GetClassParents().size());
+
+    std::vector<Ast::BaseLexer::CPtr> lexers;
+    tree.ForEach(
+        [&lexers](const Ast::BaseLexer* lexer, Ast::ASTFileTree::Params)
+        {
+            lexers.emplace_back(lexer);
+            return true;
+        });
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i)
+    {
+        threads.emplace_back(
+            [&lexers]()
+            {
+                for (auto&& lexer : lexers)
+                {
+                    if (const auto classLexer = boost::dynamic_pointer_cast<const Ast::Cpp::ClassLexer>(lexer))
+                    {
+                        (void)classLexer->GetFields();
+                        (void)classLexer->IsTemplate();
+                    }
+                    else if (const auto enumLexer = boost::dynamic_pointer_cast<const Ast::Cpp::EnumClassLexer>(lexer))
+                    {
+                        (void)enumLexer->GetConstants();
+                    }
+                }
+            });
+    }
+    for (auto&& thread : threads)
+    {
+        thread.join();
+    }
+
+    ASSERT_EQ(eagerClass->GetFields().size(), lazyClass->GetFields().size());
+    for (std::size_t i = 0; i < eagerClass->GetFields().size(); ++i)
+    {
+        EXPECT_EQ(eagerClass->GetFields()[i].name, lazyClass->GetFields()[i].name);
+        EXPECT_EQ(eagerClass->GetFields()[i].accessSpecifier, lazyClass->GetFields()[i].accessSpecifier);
+    }
+
+    const auto vec2 = tree.FindFirstByNameAs<Ast::Cpp::ClassLexer>("Vec2");
+    ASSERT_TRUE(vec2);
+    EXPECT_TRUE(vec2->IsTemplate());
+
+    const auto eType = tree.FindFirstByNameAs<Ast::Cpp::EnumClassLexer>("EType");
+    ASSERT_TRUE(eType);
+    EXPECT_EQ(3, eType->GetConstants().size());
+}
+
+TEST(ASTTests, SelectiveParsing)
+{
+    const auto parse = [](std::vector<Ast::String> lexerTypes)
+    {
+        auto reader = Ast::ContentStream::Create();
+        reader->Read(R"(
+namespace Outer
+{
+    class Holder
+    {
+        enum class Inner { A, B };
+    };
+
+    enum class Plain { C };
+}
+)");
+
+        Ast::LogCollector logCollector;
+        auto tree = Ast::ASTFileTree(reader);
+        tree.ParseUsing<Ast::Cpp::FileParser>(logCollector, { .lexerTypes = std::move(lexerTypes) });
+        return tree;
+    };
+
+    auto enums = parse({ Ast::Cpp::EnumClassLexer::typeName });
+    EXPECT_FALSE(enums.FindFirstByName("Outer"));
+    EXPECT_FALSE(enums.FindFirstByName("Holder"));
+    const auto inner = enums.FindFirstByNameAs<Ast::Cpp::EnumClassLexer>("Inner");
+    ASSERT_TRUE(inner);
+    EXPECT_EQ(2, inner->GetConstants().size());
+    EXPECT_EQ(inner->GetRootLexer(), inner->GetParentLexer());
+
+    // the skipped class doesn't break the binding between the namespace and the nested enum
+    auto namespacesAndEnums = parse({ Ast::Cpp::NamespaceLexer::typeName, Ast::Cpp::EnumClassLexer::typeName });
+    EXPECT_FALSE(namespacesAndEnums.FindFirstByName("Holder"));
+    const auto outer = namespacesAndEnums.FindFirstByName("Outer");
+    ASSERT_TRUE(outer);
+    ASSERT_EQ(2, outer->GetChildLexers().size());
+    EXPECT_EQ("Inner", outer->GetChildLexers()[0]->GetLexerName());
+    EXPECT_EQ("Plain", outer->GetChildLexers()[1]->GetLexerName());
+
+    auto all = parse({});
+    const auto holder = all.FindFirstByName("Holder");
+    ASSERT_TRUE(holder);
+    EXPECT_EQ(holder, all.FindFirstByName("Inner")->GetParentLexer());
+}
+
+TEST(ASTTests, MarkedOnlyParsing)
+{
+    auto reader = Ast::ContentStream::Create();
+    reader->Read(R"(
+#define CLASS(...)
+
+CLASS(Component)
+class Marked
+{
+    class NotMarkedInside {};
+    int _value = 0;
+};
+
+class NotMarked {};
+
+namespace Unmarked
+{
+    CLASS(Smth1, Smth2)
+    template<class T>
+    class MarkedTemplate : public Marked
+    {
+    };
+}
+
+NAMESPACE()
+namespace MarkedNamespace
+{
+    ENUM_CLASS()
+    enum class MarkedEnum { A, B };
+
+    enum class NotMarkedEnum { C };
+}
+)");
+
+    Ast::LogCollector logCollector;
+    Ast::ASTFileTree tree(reader);
+    tree.ParseUsing<Ast::Cpp::FileParser>(logCollector, { .markedOnly = true });
+
+    EXPECT_FALSE(tree.FindFirstByName("NotMarkedInside"));
+    EXPECT_FALSE(tree.FindFirstByName("NotMarked"));
+    EXPECT_FALSE(tree.FindFirstByName("Unmarked"));
+    EXPECT_FALSE(tree.FindFirstByName("NotMarkedEnum"));
+
+    const auto marked = tree.FindFirstByNameAs<Ast::Cpp::ClassLexer>("Marked");
+    ASSERT_TRUE(marked);
+    ASSERT_TRUE(marked->IsMarked());
+    EXPECT_EQ("Component", marked->GetMark()->params.front());
+    ASSERT_EQ(1, marked->GetFields().size());
+    EXPECT_EQ("_value", marked->GetFields()[0].name);
+
+    const auto markedTemplate = tree.FindFirstByNameAs<Ast::Cpp::ClassLexer>("MarkedTemplate");
+    ASSERT_TRUE(markedTemplate);
+    EXPECT_TRUE(markedTemplate->IsTemplate());
+    ASSERT_TRUE(markedTemplate->IsMarked());
+    EXPECT_EQ("Smth2", markedTemplate->GetMark()->params.back());
+
+    const auto markedNamespace = tree.FindFirstByName("MarkedNamespace");
+    ASSERT_TRUE(markedNamespace);
+    ASSERT_EQ(1, markedNamespace->GetChildLexers().size());
+    EXPECT_EQ("MarkedEnum", markedNamespace->GetChildLexers()[0]->GetLexerName());
+}
+
+TEST(ASTTests, KeywordPrefilter)
+{
+    // long enough for the vector loads, and the last declaration is left for the scalar tail
+    const Ast::String data(R"(
+int classic = 0; // class, enum and namespace inside of a line aren't candidates
+void my_enum() { return; }
+namespace_t value;
+    namespace A
+    {
+        enum class B : int { C };
+        class D {};
+    }
+class E {};)");
+
+    constexpr std::array<Ast::StringView, 3> keywords = { "namespace", "enum", "class" };
+    const Ast::Cpp::KeywordPrefilter prefilter(data, keywords);
+    EXPECT_FALSE(prefilter.IsEmpty());
+
+    const auto toHeaders = [](const Ast::Cpp::KeywordPrefilter::Anchors& anchors)
+    {
+        std::vector<std::string> headers;
+        for (auto&& anchor : anchors)
+        {
+            std::string header(anchor, std::strcspn(anchor, "{\n"));
+            header.erase(header.find_last_not_of(' ') + 1);
+            headers.push_back(std::move(header));
+        }
+        return headers;
+    };
+    EXPECT_EQ((std::vector<std::string>{ "namespace A" }), toHeaders(prefilter.GetDeclarations(0)));
+    EXPECT_EQ((std::vector<std::string>{ "enum class B : int" }), toHeaders(prefilter.GetDeclarations(1)));
+    EXPECT_EQ((std::vector<std::string>{ "class D", "class E" }), toHeaders(prefilter.GetDeclarations(2)));
+
+    EXPECT_TRUE(Ast::Cpp::KeywordPrefilter(Ast::String("int main() { return classic + enumerate(); }"), keywords).IsEmpty());
+
+    // a content without declarations is skipped, but still gets its file lexer
+    auto reader = Ast::ContentStream::Create();
+    reader->Read("int main() { return 0; }");
+    Ast::LogCollector logCollector;
+    Ast::ASTFileTree tree(reader);
+    tree.ParseUsing<Ast::Cpp::FileParser>(logCollector);
+    EXPECT_FALSE(tree.FindFirstByName("main"));
+    EXPECT_EQ(1, tree.GetNodeTable()->GetSize());
+}
+
+TEST(ASTTests, FileParserOverLexerTypes)
+{
+    auto reader = Ast::ContentStream::Create();
+    reader->Read(content);
+    reader->ApplyFilters<Ast::Cpp::CommentFilter>();
+    auto sideTables = Ast::LexerSideTables::Create(reader);
+
+    Ast::LogCollector logCollector;
+    Ast::Cpp::FileParserT<Ast::Cpp::EnumClassLexer> enumParser;
+    ASSERT_TRUE(enumParser.Parse(sideTables, logCollector));
+    EXPECT_FALSE(enumParser.GetLexers<Ast::Cpp::EnumClassLexer>().empty());
+    static_assert(sizeof(Ast::Cpp::FileParserT<Ast::Cpp::EnumClassLexer>) < sizeof(Ast::Cpp::FileParser));
+
+    std::size_t enumsCount = 0;
+    enumParser.ForEachLexer(
+        [&enumsCount](Ast::Cpp::EnumClassLexer* lexer)
+        {
+            EXPECT_EQ(Ast::Cpp::EnumClassLexer::typeName, lexer->GetLexerType());
+            ++enumsCount;
+            return true;
+        });
+    EXPECT_EQ(enumParser.GetLexers<Ast::Cpp::EnumClassLexer>().size(), enumsCount);
+
+    Ast::ASTFileTree tree(reader);
+    tree.ParseUsing<Ast::Cpp::FileParserT<Ast::Cpp::NamespaceLexer, Ast::Cpp::EnumClassLexer>>(logCollector);
+    EXPECT_FALSE(tree.FindFirstByName("GlobalClass"));
+    const auto readerType = tree.FindFirstByNameAs<Ast::Cpp::EnumClassLexer>("ReaderType");
+    ASSERT_TRUE(readerType);
+    EXPECT_EQ("long long", readerType->GetType());
+
+    const auto fullTree = GetASTFileTree(logCollector);
+    const auto pinnedTable = fullTree.GetNodeTable();
+    const auto& nodeTable = *pinnedTable;
+    const auto enumTag = Ast::NodeTable::GetTypeTag(Ast::Cpp::EnumClassLexer::typeName);
+    std::size_t fullEnumsCount = 0;
+    for (Ast::NodeTable::NodeId node = 0; node < nodeTable.GetSize(); ++node)
+    {
+        fullEnumsCount += nodeTable.GetTypeTag(node) == enumTag ? 1 : 0;
+    }
+    EXPECT_EQ(fullEnumsCount, enumsCount);
+}
+
+TEST(ASTTests, CommentAndLiteralMasks)
+{
+    const auto* source = R"(// class Commented {};
+namespace Masked /* { */
+{
+    /*
+    class InBlockComment {};
+    */
+    class Widget
+    {
+        std::string _text = "}; int _fake = 0;";
+        char _bracket = '}';
+        int _count = 1'000; // int _commented;
+        std::string_view _raw = R"x(
+class InRawString {};
+)x";
+    };
+
+    enum class Mode
+    {
+        First, // Commented,
+        Second /* , AlsoCommented */
+    };
+}
+)";
+
+    auto reader = Ast::ContentStream::Create();
+    reader->Read(source);
+    reader->ApplyMasks<Ast::Cpp::CommentAndLiteralMasker>();
+    EXPECT_EQ(source, std::string(reader->Data().c_str()));
+    EXPECT_FALSE(reader->GetMask().IsEmpty());
+
+    Ast::LogCollector logCollector;
+    Ast::ASTFileTree tree(reader);
+    tree.ParseUsing<Ast::Cpp::FileParser>(logCollector);
+
+    EXPECT_FALSE(tree.FindFirstByName("Commented"));
+    EXPECT_FALSE(tree.FindFirstByName("InBlockComment"));
+    EXPECT_FALSE(tree.FindFirstByName("InRawString"));
+
+    const auto masked = tree.FindFirstByName("Masked");
+    ASSERT_TRUE(masked);
+    EXPECT_EQ(3, masked->GetOpenScope()->line);
+    EXPECT_EQ(22, masked->GetCloseScope()->line);
+
+    const auto widget = tree.FindFirstByNameAs<Ast::Cpp::ClassLexer>("Widget");
+    ASSERT_TRUE(widget);
+    EXPECT_EQ(masked, widget->GetParentLexer());
+    EXPECT_EQ(8, widget->GetOpenScope()->line);
+    EXPECT_EQ(15, widget->GetCloseScope()->line);
+
+    std::vector<std::string> fields;
+    for (auto&& field : widget->GetFields())
+    {
+        fields.emplace_back(field.name.c_str());
+    }
+    EXPECT_EQ((std::vector<std::string>{ "_text", "_bracket", "_count", "_raw" }), fields);
+
+    const auto mode = tree.FindFirstByNameAs<Ast::Cpp::EnumClassLexer>("Mode");
+    ASSERT_TRUE(mode);
+    ASSERT_EQ(2, mode->GetConstants().size());
+    EXPECT_EQ("First", mode->GetConstants()[0].name);
+    EXPECT_EQ("Second", mode->GetConstants()[1].name);
+}
+
+namespace
+{
+    struct CarriageReturnFilter final : public Ast::StreamingContentFilter
+    {
+        void Process(Ast::StringView chunk, Buffer& output) override
+        {
+            for (const auto ch : chunk)
+            {
+                if (ch != '\r')
+                {
+                    output += ch;
+                }
+            }
+        }
+
+        void Finish(Buffer&) override {}
+    };
+} // namespace
+
+TEST(ASTTests, StreamingFilters)
+{
+    const std::string source = "class A // comment {\r\n"
+                               "{\r\n"
+                               "    /* multi\r\n"
+                               "       line */ int _a = 0;\r\n"
+                               "    const char* _url = \"http://site\"; // continued \\\r\n"
+                               "    still comment\r\n"
+                               "    char _slash = '/'; int _b = 1'000; int _c = 4 / 2;\r\n"
+                               "};\r\n";
+    const std::string expected = "class A \n"
+                                 "{\n"
+                                 "    \n"
+                                 " int _a = 0;\n"
+                                 "    const char* _url = \"http://site\"; \n"
+                                 "\n"
+                                 "    char _slash = '/'; int _b = 1'000; int _c = 4 / 2;\n"
+                                 "};\n";
+
+    auto reader = Ast::ContentStream::Create();
+    reader->Read(source.c_str());
+    reader->ApplyFilters<Ast::Cpp::CommentFilter, CarriageReturnFilter>();
+    EXPECT_EQ(expected, reader->Data().c_str());
+
+    // a state is carried between chunks, so any split gives the same result
+    Ast::Cpp::CommentFilter commentFilter;
+    Ast::StreamingContentFilter::Buffer output;
+    for (const auto ch : source)
+    {
+        commentFilter.Process(Ast::StringView(&ch, 1), output);
+    }
+    commentFilter.Finish(output);
+    std::erase(output, '\r');
+    EXPECT_EQ(expected, output);
+
+    // comment markers inside of raw strings and prefixed character literals
+    const std::vector<std::pair<std::string, std::string>> literals = {
+        { "auto s = R\"(first\n/* not a comment)\";\nclass Kept {};\n/* real */ int z;\n",
+          "auto s = R\"(first\n/* not a comment)\";\nclass Kept {};\n int z;\n" },
+        { "auto s = u8R\"tag(// )\" )tag\"; // real\nint y;\n", "auto s = u8R\"tag(// )\" )tag\"; \nint y;\n" },
+        { "wchar_t c = L'\"'; // comment\nint x = 0x1'F; // comment\n", "wchar_t c = L'\"'; \nint x = 0x1'F; \n" },
+    };
+    for (auto&& [text, expectedText] : literals)
+    {
+        auto literalsReader = Ast::ContentStream::Create();
+        literalsReader->Read(text.c_str());
+        literalsReader->ApplyFilters<Ast::Cpp::CommentFilter>();
+        EXPECT_EQ(expectedText, literalsReader->Data().c_str());
+
+        Ast::Cpp::CommentFilter chunkedFilter;
+        Ast::StreamingContentFilter::Buffer chunkedOutput;
+        for (const auto ch : text)
+        {
+            chunkedFilter.Process(Ast::StringView(&ch, 1), chunkedOutput);
+        }
+        chunkedFilter.Finish(chunkedOutput);
+        EXPECT_EQ(expectedText, chunkedOutput);
+    }
+}
+
+TEST(ASTTests, ConcurrentLogCollector)
+{
+    static constexpr std::size_t threadsCount = 4;
+    static constexpr std::size_t logsCount = 1000;
+
+    Ast::LogCollector logCollector;
+    std::size_t dispatchedCount = 0;
+    std::thread::id dispatchThread;
+    logCollector.Subscribe(
+        [&](const Ast::String&, Ast::LogCollector::LogType)
+        {
+            ++dispatchedCount;
+            dispatchThread = std::this_thread::get_id();
+        });
+    logCollector.StartAsyncDispatch();
+    EXPECT_TRUE(logCollector.IsAsyncDispatch());
+
+    std::vector<std::thread> producers;
+    for (std::size_t i = 0; i < threadsCount; ++i)
+    {
+        producers.emplace_back(
+            [&logCollector, i]()
+            {
+                const Ast::LogCollector::FileScope fileScope(Ast::Symbol(Ast::String::Format("file{}.h", i)));
+                for (std::size_t line = logsCount; line > 0; --line)
+                {
+                    logCollector.AddLog({ "message", Ast::LogCollector::LogType::Info, {}, line });
+                }
+            });
+    }
+    for (auto&& producer : producers)
+    {
+        producer.join();
+    }
+
+    logCollector.Flush();
+    EXPECT_EQ(threadsCount * logsCount, dispatchedCount);
+    EXPECT_NE(std::this_thread::get_id(), dispatchThread);
+
+    logCollector.StopAsyncDispatch();
+    EXPECT_FALSE(logCollector.IsAsyncDispatch());
+
+    logCollector.SortLogs();
+    const auto& logs = logCollector.GetLogs();
+    ASSERT_EQ(threadsCount * logsCount, logs.size());
+    for (std::size_t i = 0; i < logs.size(); ++i)
+    {
+        EXPECT_EQ(Ast::String::Format("file{}.h", i / logsCount).ToStringView(), logs[i].file.ToStringView());
+        EXPECT_EQ(i % logsCount + 1, logs[i].line);
+    }
+
+    // after stopping the sinks are called right away again
+    logCollector.AddLog({ "message", Ast::LogCollector::LogType::Info });
+    EXPECT_EQ(threadsCount * logsCount + 1, dispatchedCount);
+    EXPECT_EQ(std::this_thread::get_id(), dispatchThread);
+    EXPECT_TRUE(logCollector.GetLogs().back().file.IsEmpty());
+
+    const Ast::LogCollector copy = logCollector;
+    EXPECT_EQ(threadsCount * logsCount + 1, copy.GetLogs().size());
+}
+
+TEST(ASTTests, StructuredLogs)
+{
+    static constexpr auto classCode = R"(
+        namespace A
+        {
+            class B
+            {
+            };
+        }
+    )";
+
+    const auto parse = [](Ast::LogCollector& logCollector)
+    {
+        auto reader = Ast::ContentStream::Create();
+        reader->Read(classCode);
+        Ast::ASTFileTree tree(reader);
+        tree.ParseUsing<Ast::Cpp::FileParser>(logCollector);
+    };
+
+    {
+        Ast::LogCollector logCollector;
+        std::vector<std::string> messages;
+        logCollector.Subscribe([&messages](const Ast::String& message, Ast::LogCollector::LogType) { messages.emplace_back(message.c_str()); });
+        parse(logCollector);
+
+        const auto& logs = logCollector.GetLogs();
+        const auto parsed = std::ranges::find(logs, Ast::LogCollector::EventCode::LexerParsed, &Ast::LogCollector::LogLine::code);
+        ASSERT_NE(logs.end(), parsed);
+        // the message is built only for the sinks
+        EXPECT_TRUE(parsed->message.IsEmpty());
+        EXPECT_EQ(5u, parsed->line); // the line of the opened scope
+        EXPECT_EQ("successfull parsing of the class: 'B'", std::string(parsed->Render().c_str()));
+        EXPECT_NE(messages.end(), std::ranges::find(messages, "successfull parsing of the class: 'B'"));
+        EXPECT_NE(messages.end(), std::ranges::find(messages, "Successfully was build binding between lexers at file: 'none'"));
+        EXPECT_EQ(logs.size(), messages.size());
+    }
+
+    {
+        Ast::LogCollector logCollector;
+        logCollector.SetSeverityThreshold(Ast::LogCollector::LogType::Info);
+        EXPECT_FALSE(logCollector.IsEnabled(Ast::LogCollector::LogType::Success));
+        EXPECT_TRUE(logCollector.IsEnabled(Ast::LogCollector::LogType::Error));
+        parse(logCollector);
+        EXPECT_TRUE(logCollector.IsEmpty());
+
+        logCollector.AddLog({ "warning", Ast::LogCollector::LogType::Warning });
+        EXPECT_TRUE(logCollector.HasAny<Ast::LogCollector::LogType::Warning>());
+        EXPECT_EQ("warning", std::string(logCollector.GetLogs().front().Render().c_str()));
+
+        // a plain record leaves the structured fields empty
+        const auto& warning = logCollector.GetLogs().front();
+        EXPECT_EQ(Ast::LogCollector::EventCode::Message, warning.code);
+        EXPECT_TRUE(std::ranges::all_of(warning.arguments, &Ast::Symbol::IsEmpty));
+    }
+}
+
+TEST(ASTTests, IndexedLogQueries)
+{
+    using LogType = Ast::LogCollector::LogType;
+
+    Ast::LogCollector logCollector;
+    EXPECT_FALSE(logCollector.HasAny<LogType::Error>());
+
+    logCollector.AddLog({ "second error", LogType::Error, Ast::Symbol(Ast::StringView("b.h")) });
+    logCollector.AddLog({ "warning", LogType::Warning, Ast::Symbol(Ast::StringView("a.h")) });
+    logCollector.AddLog({ "first error", LogType::Error, Ast::Symbol(Ast::StringView("a.h")) });
+
+    EXPECT_TRUE(logCollector.HasAny<LogType::Error>());
+    EXPECT_TRUE(logCollector.HasAny<LogType::Warning>());
+    EXPECT_FALSE(logCollector.HasAny<LogType::Info>());
+    EXPECT_EQ(2u, logCollector.GetCount(LogType::Error));
+    EXPECT_EQ(1u, logCollector.GetCount(LogType::Warning));
+
+    const auto collectMessages = [&logCollector]()
+    {
+        std::vector<std::string> messages;
+        for (const auto& logLine : logCollector.GetFilteredLogs<LogType::Error>())
+        {
+            messages.emplace_back(logLine.message.c_str());
+        }
+        return messages;
+    };
+    EXPECT_EQ((std::vector<std::string>{ "second error", "first error" }), collectMessages());
+
+    // the indices follow the new order
+    logCollector.SortLogs();
+    EXPECT_EQ((std::vector<std::string>{ "first error", "second error" }), collectMessages());
+    EXPECT_TRUE(logCollector.GetFilteredLogs(LogType::Info).empty());
+
+    const auto copy = logCollector;
+    EXPECT_EQ(2u, copy.GetCount(LogType::Error));
+    EXPECT_EQ(2, std::ranges::distance(copy.GetFilteredLogs<LogType::Error>()));
+
+    logCollector.ClearLogs();
+    EXPECT_FALSE(logCollector.HasAny<LogType::Error>());
+    EXPECT_EQ(0u, logCollector.GetCount(LogType::Warning));
+}
+
+TEST(ASTTests, AggregatedLogs)
+{
+    using LogType = Ast::LogCollector::LogType;
+
+    Ast::LogCollector logCollector;
+    logCollector.SetAggregation(2);
+    std::vector<std::string> messages;
+    logCollector.Subscribe([&messages](const Ast::String& message, LogType) { messages.emplace_back(message.c_str()); });
+
+    for (std::size_t i = 1; i <= 3000; ++i)
+    {
+        const Ast::LogCollector::FileScope fileScope(Ast::Symbol(Ast::String::Format("file{}.h", i)));
+        logCollector.AddLog({ Ast::String::Format("Impossible to parse the field 'field{}' at {}", i, i), LogType::Warning, {}, i });
+        logCollector.AddLog(Ast::LogCollector::LogLine::MakeEvent(Ast::LogCollector::EventCode::LexerParsed, LogType::Success,
+                                                                  { Ast::Symbol(Ast::StringView("class")), Ast::Symbol(Ast::StringView("A")) }));
+    }
+    logCollector.AddLog({ "Other warning", LogType::Warning });
+
+    // nothing is passed to the sinks until the summary
+    EXPECT_TRUE(messages.empty());
+    EXPECT_EQ(3001u, logCollector.GetCount(LogType::Warning));
+    EXPECT_EQ(3u, logCollector.GetLogs().size());
+
+    const auto& groups = logCollector.GetGroups();
+    ASSERT_EQ(3u, groups.size());
+    EXPECT_EQ("Impossible to parse the field '{}' at {}", std::string(groups[0].pattern.c_str()));
+    EXPECT_EQ(3000u, groups[0].count);
+    ASSERT_EQ(2u, groups[0].samples.size());
+    EXPECT_EQ("file2.h", groups[0].samples[1].file.ToStringView());
+    EXPECT_EQ(2u, groups[0].samples[1].line);
+    EXPECT_EQ(3000u, groups[1].count);
+    EXPECT_EQ(1u, groups[2].count);
+
+    logCollector.EmitSummary();
+    ASSERT_EQ(3u, messages.size());
+    EXPECT_EQ("Impossible to parse the field 'field1' at 1 [3000 times, e.g. at file1.h:1 file2.h:2]", messages[0]);
+    EXPECT_EQ("Other warning", messages[2]);
+}
+
+TEST(ASTTests, RuleSet)
+{
+    using LogType = Ast::LogCollector::LogType;
+
+    Ast::LogCollector parseLogs;
+    const auto tree = GetASTFileTree(parseLogs);
+
+    Ast::Size classesCount = 0;
+    Ast::Size lowerCaseClassesCount = 0;
+    tree.ForEach<Ast::Cpp::ClassLexer>(
+        [&](const Ast::BaseLexer* lexer, auto)
+        {
+            ++classesCount;
+            lowerCaseClassesCount += lexer->GetLexerName().RegexMatch(Ast::StringView(R"([A-Z]\w*)")) ? 0 : 1;
+            return true;
+        });
+    Ast::Size namespacesCount = 0;
+    tree.ForEach<Ast::Cpp::NamespaceLexer>(
+        [&](const Ast::BaseLexer*, auto)
+        {
+            ++namespacesCount;
+            return true;
+        });
+    ASSERT_NE(0u, classesCount);
+    ASSERT_NE(0u, namespacesCount);
+
+    Ast::Cpp::NameRule::Ptr nameRule = new Ast::Cpp::NameRule(R"([A-Z]\w*)");
+    nameRule->OverrideLogType(LogType::Warning);
+    Ast::Cpp::LineCountRule::Ptr lineCountRule = new Ast::Cpp::LineCountRule(0);
+    lineCountRule->OverrideLogType(LogType::Warning);
+
+    Ast::RuleSet ruleSet;
+    ruleSet.Add<Ast::Cpp::ClassLexer>(new Ast::Cpp::Class::BaseRule);
+    ruleSet.Add<Ast::Cpp::ClassLexer>(nameRule, "class name");
+    ruleSet.Add<Ast::Cpp::NamespaceLexer>(lineCountRule);
+    EXPECT_EQ(3u, ruleSet.GetRulesCount());
+
+    Ast::LogCollector logCollector;
+    const auto result = ruleSet.Apply(tree, logCollector);
+    EXPECT_EQ(2 * classesCount + namespacesCount, result.checks);
+    // every namespace is longer than 0 lines
+    EXPECT_EQ(lowerCaseClassesCount + namespacesCount, result.violations);
+    EXPECT_EQ(result.violations, logCollector.GetCount(LogType::Warning));
+    EXPECT_FALSE(logCollector.HasAny<LogType::Error>());
+
+    std::vector<Ast::ASTFileTree::CPtr> trees;
+    for (int i = 0; i < 8; ++i)
+    {
+        trees.emplace_back(new Ast::ASTFileTree(GetASTFileTree(parseLogs)));
+    }
+
+    Ast::LogCollector parallelLogCollector;
+    const auto parallelResult = ruleSet.Apply(trees, parallelLogCollector, 4);
+    EXPECT_EQ(trees.size() * result.checks, parallelResult.checks);
+    EXPECT_EQ(trees.size() * result.violations, parallelResult.violations);
+    EXPECT_EQ(parallelResult.violations, parallelLogCollector.GetLogs().size());
+}
+
+TEST(ASTTests, PatternRegistry)
+{
+    const Ast::Pattern pattern(Ast::StringView(R"([A-Z]\w*)"));
+    ASSERT_TRUE(pattern.IsValid());
+    EXPECT_TRUE(pattern.Match("GlobalClass"));
+    EXPECT_FALSE(pattern.Match("globalClass"));
+    EXPECT_EQ(R"([A-Z]\w*)", pattern.GetExpression());
+
+    // the same expression is compiled only once
+    const auto patternsCount = Ast::Pattern::GetPatternsCount();
+    for (int i = 0; i < 10; ++i)
+    {
+        const Ast::Cpp::NameRule rule(R"([A-Z]\w*)");
+    }
+    EXPECT_EQ(patternsCount, Ast::Pattern::GetPatternsCount());
+
+    // the mode is a part of the key
+    const Ast::Pattern multiline(Ast::StringView("^b"), Ast::Pattern::Mode::Multiline);
+    const Ast::Pattern singleLine(Ast::StringView("^b"));
+    const Ast::StringView text = "a\nb";
+    Ast::Pattern::MatchResults match;
+    EXPECT_TRUE(multiline.Search(text.data(), text.data() + text.size(), match));
+    EXPECT_FALSE(singleLine.Search(text.data(), text.data() + text.size(), match));
+
+    std::vector<std::thread> threads;
+    std::atomic<int> matches = 0;
+    for (int i = 0; i < 4; ++i)
+    {
+        threads.emplace_back(
+            [&matches]()
+            {
+                for (int j = 0; j < 100; ++j)
+                {
+                    matches += Ast::Pattern(Ast::StringView(R"(\d+)")).Match("12345") ? 1 : 0;
+                }
+            });
+    }
+    for (auto&& thread : threads)
+    {
+        thread.join();
+    }
+    EXPECT_EQ(400, matches.load());
+
+    EXPECT_FALSE(Ast::Pattern().IsValid());
+    EXPECT_FALSE(Ast::Pattern().Match(""));
+
+    // user input is checked without an assertion, the result is the registered pattern
+    EXPECT_FALSE(Ast::Pattern::TryCompile("[A-Z").IsValid());
+    const auto checked = Ast::Pattern::TryCompile(R"([A-Z]\w*)");
+    ASSERT_TRUE(checked.IsValid());
+    EXPECT_EQ(pattern.GetExpression().data(), checked.GetExpression().data());
+}
+
+TEST(ASTTests, RuleConfig)
+{
+    using LogType = Ast::LogCollector::LogType;
+
+    Ast::LogCollector parseLogs;
+    const auto tree = GetASTFileTree(parseLogs);
+
+    Ast::Size classesCount = 0;
+    Ast::Size markedClassesCount = 0;
+    tree.ForEach<Ast::Cpp::ClassLexer>(
+        [&](const Ast::BaseLexer* lexer, auto)
+        {
+            ++classesCount;
+            if (const auto* mark = lexer->FindMark())
+            {
+                markedClassesCount += std::ranges::count(mark->params, Ast::String("Smth1")) != 0 ? 1 : 0;
+            }
+            return true;
+        });
+    ASSERT_NE(0u, markedClassesCount);
+
+    static constexpr Ast::StringView config = R"(# kind      lexer       parameters
+name        class       pattern=.* severity=info
+line-count  class       max=0 severity=warning marker=Smth1 message="marked class"
+
+line-count  namespace   max=100000  # never violated
+)";
+
+    Ast::RuleSet ruleSet;
+    Ast::LogCollector logCollector;
+    ASSERT_TRUE(Ast::Cpp::CompileRuleConfig(config, ruleSet, logCollector));
+    EXPECT_EQ(3u, ruleSet.GetRulesCount());
+    EXPECT_FALSE(logCollector.HasAny<LogType::Error>());
+
+    // the pattern which is checked is the one given to the rule, it's compiled once
+    const auto patternsCount = Ast::Pattern::GetPatternsCount();
+    Ast::RuleSet patternRuleSet;
+    ASSERT_TRUE(Ast::Cpp::CompileRuleConfig("name class pattern=RuleConfigOnly\\w+", patternRuleSet, logCollector));
+    EXPECT_EQ(patternsCount + 1, Ast::Pattern::GetPatternsCount());
+
+    const auto result = ruleSet.Apply(tree, logCollector);
+    EXPECT_EQ(markedClassesCount, logCollector.GetCount(LogType::Warning));
+    EXPECT_EQ(markedClassesCount, result.violations);
+    EXPECT_LT(classesCount + markedClassesCount, result.checks);
+
+    static constexpr Ast::StringView invalidConfig = R"(name class pattern=[A-Z
+line-count struct max=1
+line-count class max=ten
+unknown class
+name class pattern=.* color=red
+line-count class message="unclosed
+)";
+
+    Ast::RuleSet invalidRuleSet;
+    Ast::LogCollector errors;
+    EXPECT_FALSE(Ast::Cpp::CompileRuleConfig(invalidConfig, invalidRuleSet, errors));
+    EXPECT_TRUE(invalidRuleSet.IsEmpty());
+    ASSERT_EQ(6u, errors.GetCount(LogType::Error));
+    EXPECT_TRUE(Ast::StringView(errors.GetLogs().front().message.CStr()).starts_with("RuleConfig: line 1:"));
+
+    // the only error of the config, the valid rules aren't added either
+    static constexpr Ast::StringView unclosedQuotesConfig = R"(name class pattern=.*
+line-count class max=1 message="unclosed
+)";
+
+    const auto programHash = ruleSet.GetProgramHash();
+    Ast::LogCollector unclosedQuotesErrors;
+    EXPECT_FALSE(Ast::Cpp::CompileRuleConfig(unclosedQuotesConfig, ruleSet, unclosedQuotesErrors));
+    EXPECT_EQ(3u, ruleSet.GetRulesCount());
+    EXPECT_EQ(programHash, ruleSet.GetProgramHash());
+    ASSERT_EQ(1u, unclosedQuotesErrors.GetCount(LogType::Error));
+    EXPECT_EQ("RuleConfig: line 2: unclosed quotes", unclosedQuotesErrors.GetLogs().front().message);
+}
+
+TEST(ASTTests, MarkerDispatch)
+{
+    using LogType = Ast::LogCollector::LogType;
+
+    Ast::LogCollector parseLogs;
+    const auto tree = GetASTFileTree(parseLogs);
+
+    Ast::Size firstMarkedCount = 0;
+    Ast::Size secondMarkedCount = 0;
+    tree.ForEach<Ast::Cpp::ClassLexer>(
+        [&](const Ast::BaseLexer* lexer, auto)
+        {
+            if (const auto* mark = lexer->FindMark())
+            {
+                firstMarkedCount += std::ranges::count(mark->params, Ast::String("Smth1")) != 0 ? 1 : 0;
+                secondMarkedCount += mark->rule == "CLASS" && std::ranges::count(mark->params, Ast::String("Smth2")) != 0 ? 1 : 0;
+            }
+            return true;
+        });
+    ASSERT_NE(0u, firstMarkedCount);
+    ASSERT_NE(0u, secondMarkedCount);
+
+    Ast::Cpp::LineCountRule::Ptr alwaysViolated = new Ast::Cpp::LineCountRule(0);
+    alwaysViolated->OverrideLogType(LogType::Warning);
+
+    Ast::RuleSet ruleSet;
+    ruleSet.Add<Ast::Cpp::ClassLexer>(alwaysViolated, "any mark", "Smth1");
+    ruleSet.Add<Ast::Cpp::ClassLexer>(alwaysViolated, "class mark", "CLASS(Smth2)");
+    ruleSet.Add<Ast::Cpp::ClassLexer>(alwaysViolated, "other mark", "ENUM_CLASS(Smth2)");
+    ruleSet.Add<Ast::Cpp::NamespaceLexer>(alwaysViolated, "unmarked lexer type", "Smth1");
+    EXPECT_EQ(4u, ruleSet.GetRulesCount());
+    EXPECT_EQ(4u, ruleSet.GetMarkedRulesCount());
+
+    Ast::LogCollector logCollector;
+    const auto result = ruleSet.Apply(tree, logCollector);
+    EXPECT_EQ(firstMarkedCount + secondMarkedCount, result.checks);
+    EXPECT_EQ(result.checks, result.violations);
+    EXPECT_EQ(result.violations, logCollector.GetCount(LogType::Warning));
+}
+
+TEST(ASTTests, RuleCache)
+{
+    using LogType = Ast::LogCollector::LogType;
+
+    Ast::LogCollector parseLogs;
+    const auto tree = GetASTFileTree(parseLogs);
+
+    Ast::Cpp::LineCountRule::Ptr lineCountRule = new Ast::Cpp::LineCountRule(0);
+    lineCountRule->OverrideLogType(LogType::Warning);
+
+    Ast::RuleSet ruleSet;
+    ruleSet.Add<Ast::Cpp::ClassLexer>(new Ast::Cpp::NameRule(R"([A-Z]\w*)"));
+    ruleSet.Add<Ast::Cpp::NamespaceLexer>(lineCountRule, "namespace");
+
+    Ast::LogCollector expectedLogs;
+    const auto expected = ruleSet.Apply(tree, expectedLogs);
+    ASSERT_NE(0u, expected.violations);
+
+    const auto cachePath = std::filesystem::temp_directory_path() / "ASTTests.RuleCache";
+    {
+        Ast::RuleCache cache;
+        EXPECT_FALSE(cache.Load(cachePath / "absent"));
+
+        Ast::LogCollector logCollector;
+        const auto result = ruleSet.Apply(tree, logCollector, &cache);
+        EXPECT_EQ(expected.checks, result.checks);
+        EXPECT_EQ(expected.violations, result.violations);
+        EXPECT_EQ(0u, cache.GetHitsCount());
+        EXPECT_NE(0u, cache.GetMissesCount());
+        EXPECT_EQ(expectedLogs.GetLogs().size(), logCollector.GetLogs().size());
+        ASSERT_TRUE(cache.Save(cachePath));
+    }
+
+    // the next run replays everything
+    {
+        Ast::RuleCache cache;
+        ASSERT_TRUE(cache.Load(cachePath));
+
+        Ast::LogCollector logCollector;
+        const auto result = ruleSet.Apply(tree, logCollector, &cache);
+        EXPECT_EQ(expected.checks, result.checks);
+        EXPECT_EQ(expected.violations, result.violations);
+        EXPECT_EQ(0u, cache.GetMissesCount());
+        EXPECT_NE(0u, cache.GetHitsCount());
+
+        const auto& logs = logCollector.GetLogs();
+        const auto& expectedLines = expectedLogs.GetLogs();
+        ASSERT_EQ(expectedLines.size(), logs.size());
+        for (Ast::Size i = 0; i < logs.size(); ++i)
+        {
+            EXPECT_EQ(expectedLines[i].Render(), logs[i].Render());
+            EXPECT_EQ(expectedLines[i].type, logs[i].type);
+        }
+    }
+
+    // any change of the rules invalidates the cached results
+    {
+        Ast::RuleCache cache;
+        ASSERT_TRUE(cache.Load(cachePath));
+
+        Ast::RuleSet changedRuleSet;
+        changedRuleSet.Add<Ast::Cpp::ClassLexer>(new Ast::Cpp::NameRule(R"([A-Z]\w*)"));
+        changedRuleSet.Add<Ast::Cpp::NamespaceLexer>(new Ast::Cpp::LineCountRule(100000), "namespace");
+        EXPECT_NE(ruleSet.GetProgramHash(), changedRuleSet.GetProgramHash());
+
+        Ast::LogCollector logCollector;
+        const auto result = changedRuleSet.Apply(tree, logCollector, &cache);
+        EXPECT_EQ(0u, cache.GetHitsCount());
+        EXPECT_EQ(result.violations, logCollector.GetLogs().size());
+    }
+
+    // a rule changed after it was added
+    {
+        Ast::RuleCache cache;
+        ASSERT_TRUE(cache.Load(cachePath));
+
+        const auto programHash = ruleSet.GetProgramHash();
+        lineCountRule->SetMaxLineCount(100000);
+        EXPECT_NE(programHash, ruleSet.GetProgramHash());
+
+        Ast::LogCollector logCollector;
+        const auto result = ruleSet.Apply(tree, logCollector, &cache);
+        EXPECT_EQ(0u, cache.GetHitsCount());
+        EXPECT_NE(0u, cache.GetMissesCount());
+        EXPECT_GT(expected.violations, result.violations);
+    }
+
+    // a damaged file is rejected as a whole, its sizes never turn into allocations
+    {
+        std::ifstream input(cachePath, std::ios::binary);
+        const std::string bytes{ std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>() };
+        ASSERT_GT(bytes.size(), 44u);
+
+        const auto loadDamaged = [&cachePath](const std::string& damaged)
+        {
+            const auto damagedPath = cachePath.string() + ".damaged";
+            std::ofstream(damagedPath, std::ios::binary) << damaged;
+
+            Ast::RuleCache cache;
+            const auto loaded = cache.Load(damagedPath);
+            std::filesystem::remove(damagedPath);
+            EXPECT_EQ(nullptr, cache.Find(0));
+            return loaded;
+        };
+
+        EXPECT_TRUE(loadDamaged(bytes));
+        EXPECT_FALSE(loadDamaged(bytes.substr(0, bytes.size() / 2)));
+        EXPECT_FALSE(loadDamaged(bytes.substr(0, bytes.size() - 1)));
+
+        auto hugeEntriesCount = bytes;
+        std::fill_n(hugeEntriesCount.begin() + 8, 8, '\xff'); // the count of the entries
+        EXPECT_FALSE(loadDamaged(hugeEntriesCount));
+
+        auto hugeRecordsCount = bytes;
+        std::fill_n(hugeRecordsCount.begin() + 40, 4, '\xff'); // the count of the records of the first entry
+        EXPECT_FALSE(loadDamaged(hugeRecordsCount));
+
+        EXPECT_FALSE(loadDamaged(std::string(bytes.size(), '\xff')));
+    }
+
+    std::filesystem::remove(cachePath);
+}
+
+TEST(ASTTests, ParseDeadline)
+{
+    using LogType = Ast::LogCollector::LogType;
+
+    const auto parse = [](const std::string& text, const Ast::ParseOptions& options, Ast::LogCollector& logCollector)
+    {
+        auto reader = Ast::ContentStream::Create();
+        reader->Read(text.c_str());
+
+        Ast::ASTFileTree tree(reader);
+        tree.ParseUsing<Ast::Cpp::FileParser>(logCollector, options);
+        return tree;
+    };
+
+    {
+        Ast::LogCollector logCollector;
+        const auto tree = parse(content, {}, logCollector);
+        EXPECT_TRUE(tree.IsComplete());
+        EXPECT_FALSE(logCollector.HasAny<LogType::Error>());
+    }
+
+    {
+        Ast::CancellationToken::Ptr token = new Ast::CancellationToken;
+        token->Cancel();
+
+        Ast::ParseOptions options;
+        options.cancellationToken = token;
+        Ast::LogCollector logCollector;
+        auto tree = parse(content, options, logCollector);
+        EXPECT_FALSE(tree.IsComplete());
+        EXPECT_EQ(1u, tree.GetNodeTable()->GetSize()); // the file lexer only
+        ASSERT_EQ(1u, logCollector.GetCount(LogType::Error));
+        EXPECT_EQ("FileParser: the parsing was cancelled, the tree is partial", logCollector.GetFilteredLogs(LogType::Error).front().message);
+
+        tree.Teardown();
+        EXPECT_TRUE(tree.IsComplete());
+    }
+
+    // every unbalanced scope is searched to the end of the content
+    std::string unbalanced;
+    for (int i = 0; i < 20000; ++i)
+    {
+        unbalanced += "class A" + std::to_string(i) + "\n{\n";
+    }
+
+    Ast::ParseOptions options;
+    options.timeBudget = std::chrono::milliseconds(20);
+    Ast::LogCollector logCollector;
+    const auto start = std::chrono::steady_clock::now();
+    const auto tree = parse(unbalanced, options, logCollector);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(2));
+    EXPECT_FALSE(tree.IsComplete());
+    ASSERT_EQ(1u, logCollector.GetCount(LogType::Error));
+    EXPECT_EQ("FileParser: the time budget of 20 ms was exceeded, the tree is partial",
+              logCollector.GetFilteredLogs(LogType::Error).front().message);
 }
\ No newline at end of file